@@ -141,6 +141,71 @@ Please, check that provided directories are correct.
     AC_MSG_ERROR([The MPI library does not support standard 3.0 or later])
   fi
 
+  # Check whether the MPI library provides the persistent collectives of the
+  # MPI 4.0 standard or, otherwise, the MPIX extension of Open MPI
+  AC_MSG_CHECKING([whether MPI supports persistent collectives])
+  mpi_persistent_colls=no
+  AC_LINK_IFELSE(
+    [AC_LANG_PROGRAM(
+      [
+        #include <mpi.h>
+      ],
+      [
+        MPI_Request request;
+        MPI_Allreduce_init(0, 0, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD, MPI_INFO_NULL, &request);
+      ])
+    ],
+    [
+      mpi_persistent_colls=yes
+      mpi_persistent_colls_c_prefix="MPI_"
+    ],
+    [
+      AC_LINK_IFELSE(
+        [AC_LANG_PROGRAM(
+          [
+            #include <mpi.h>
+            #include <mpi-ext.h>
+          ],
+          [
+            MPI_Request request;
+            MPIX_Allreduce_init(0, 0, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD, MPI_INFO_NULL, &request);
+          ])
+        ],
+        [
+          mpi_persistent_colls=yes
+          mpi_persistent_colls_c_prefix="MPIX_"
+        ])
+    ])
+  AC_MSG_RESULT([${mpi_persistent_colls}])
+
+  if test x"${mpi_persistent_colls}" = x"yes" ; then
+    AC_DEFINE([HAVE_MPI_PERSISTENT_COLLECTIVES], [1], [MPI supports persistent collectives])
+    AC_DEFINE_UNQUOTED([MPI_PERSISTENT_COLLECTIVES_C_PREFIX], ["${mpi_persistent_colls_c_prefix}"],
+      [The prefix of the C persistent collectives])
+  fi
+
+  # Check whether the MPI library provides the partitioned communication of
+  # the MPI 4.0 standard
+  AC_MSG_CHECKING([whether MPI supports partitioned communication])
+  AC_LINK_IFELSE(
+    [AC_LANG_PROGRAM(
+      [
+        #include <mpi.h>
+      ],
+      [
+        MPI_Request request;
+        MPI_Psend_init(0, 1, 1, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_INFO_NULL, &request);
+        MPI_Pready(0, request);
+      ])
+    ],
+    [mpi_partitioned=yes],
+    [mpi_partitioned=no])
+  AC_MSG_RESULT([${mpi_partitioned}])
+
+  if test x"${mpi_partitioned}" = x"yes" ; then
+    AC_DEFINE([HAVE_MPI_PARTITIONED], [1], [MPI supports partitioned communication])
+  fi
+
   AC_SUBST([mpiflags])
 
   AX_VAR_POPVALUE([CPPFLAGS])
@@ -1,14 +1,16 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #include <mpi.h>
 
 #include "Declarations.hpp"
 #include "Environment.hpp"
+#include "Interface.hpp"
 #include "OperationManager.hpp"
+#include "PersistentRequests.hpp"
 #include "Symbol.hpp"
 
 using namespace tampi;
@@ -43,6 +45,20 @@ int TAMPI_Ialltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
 	}
 }
 
+int TAMPI_Alltoall_init(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+		void *recvbuf, int recvcount, MPI_Datatype recvtype,
+		MPI_Comm comm, MPI_Info info,
+		MPI_Request *request)
+{
+	if (Environment::isNonBlockingEnabled()) {
+		return PersistentRequests::createCollective(Interface<C>::mpi_alltoall_init, comm, request,
+			sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm, info, request);
+	} else {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+}
+
 } // extern C
 
 #pragma GCC visibility pop
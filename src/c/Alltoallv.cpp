@@ -1,14 +1,16 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #include <mpi.h>
 
 #include "Declarations.hpp"
 #include "Environment.hpp"
+#include "Interface.hpp"
 #include "OperationManager.hpp"
+#include "PersistentRequests.hpp"
 #include "Symbol.hpp"
 
 using namespace tampi;
@@ -41,6 +43,19 @@ int TAMPI_Ialltoallv(const void *sendbuf, const int sendcounts[], const int sdis
 	}
 }
 
+int TAMPI_Alltoallv_init(const void *sendbuf, const int sendcounts[], const int sdispls[], MPI_Datatype sendtype,
+		void *recvbuf, const int recvcounts[], const int rdispls[], MPI_Datatype recvtype, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request)
+{
+	if (Environment::isNonBlockingEnabled()) {
+		return PersistentRequests::createCollective(Interface<C>::mpi_alltoallv_init, comm, request,
+			sendbuf, sendcounts, sdispls, sendtype, recvbuf, recvcounts, rdispls, recvtype, comm, info, request);
+	} else {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+}
+
 } // extern C
 
 #pragma GCC visibility pop
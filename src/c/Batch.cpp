@@ -0,0 +1,112 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+
+#include "Declarations.hpp"
+#include "Environment.hpp"
+#include "OperationManager.hpp"
+#include "TAMPI_Wrappers.h"
+
+using namespace tampi;
+
+//! \brief Get the operation code of a batch operation kind
+//!
+//! \param kind The kind of the batch operation
+//!
+//! \returns The operation code or NONE if the kind is invalid
+static OpCode getBatchOpCode(int kind)
+{
+	switch (kind) {
+		case TAMPI_BATCH_SEND:
+			return SEND;
+		case TAMPI_BATCH_BSEND:
+			return BSEND;
+		case TAMPI_BATCH_RSEND:
+			return RSEND;
+		case TAMPI_BATCH_SSEND:
+			return SSEND;
+		case TAMPI_BATCH_RECV:
+			return RECV;
+		default:
+			return NONE;
+	}
+}
+
+#pragma GCC visibility push(default)
+
+extern "C" {
+
+int TAMPI_Isendv(int count, const void *const bufs[], const int counts[],
+		const MPI_Datatype datatypes[], const int dests[], const int tags[],
+		MPI_Comm comm)
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+	if (count < 0)
+		return MPI_ERR_COUNT;
+
+	OperationManager<C, Operation>::processBatch(count,
+		[&](TaskingModel::task_handle_t task, int o) {
+			return Operation<C>(task, SEND, NONBLK, bufs[o], counts[o],
+				datatypes[o], dests[o], tags[o], comm);
+		});
+	return MPI_SUCCESS;
+}
+
+int TAMPI_Irecvv(int count, void *const bufs[], const int counts[],
+		const MPI_Datatype datatypes[], const int sources[], const int tags[],
+		MPI_Comm comm, MPI_Status statuses[])
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+	if (count < 0)
+		return MPI_ERR_COUNT;
+
+	const bool ignoreStatuses = (statuses == MPI_STATUSES_IGNORE);
+
+	OperationManager<C, Operation>::processBatch(count,
+		[&](TaskingModel::task_handle_t task, int o) {
+			MPI_Status *status = (ignoreStatuses) ? MPI_STATUS_IGNORE : &statuses[o];
+			return Operation<C>(task, RECV, NONBLK, bufs[o], counts[o],
+				datatypes[o], sources[o], tags[o], comm, status);
+		});
+	return MPI_SUCCESS;
+}
+
+int TAMPI_Ibatch(int count, const TAMPI_Batch_op ops[], MPI_Comm comm)
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+	if (count < 0)
+		return MPI_ERR_COUNT;
+
+	// Validate the whole batch before submitting any operation
+	for (int o = 0; o < count; ++o) {
+		if (getBatchOpCode(ops[o].kind) == NONE)
+			return MPI_ERR_ARG;
+	}
+
+	OperationManager<C, Operation>::processBatch(count,
+		[&](TaskingModel::task_handle_t task, int o) {
+			const TAMPI_Batch_op &op = ops[o];
+			OpCode code = getBatchOpCode(op.kind);
+			MPI_Status *status = (code == RECV) ? op.status : MPI_STATUS_IGNORE;
+			return Operation<C>(task, code, NONBLK, op.buf, op.count,
+				op.datatype, op.peer, op.tag, comm, status);
+		});
+	return MPI_SUCCESS;
+}
+
+} // extern C
+
+#pragma GCC visibility pop
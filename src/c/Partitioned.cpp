@@ -0,0 +1,105 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+
+#include "Declarations.hpp"
+#include "Environment.hpp"
+#include "Interface.hpp"
+#include "PersistentRequests.hpp"
+#include "TAMPI_Wrappers.h"
+#include "TicketManager.hpp"
+
+using namespace tampi;
+
+//! \brief Check whether partitioned operations can be used
+//!
+//! \param func The name of the calling function
+//!
+//! \returns Whether they are enabled and supported by MPI
+static bool checkPartitioned(const char *func)
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(func, " not enabled");
+		return false;
+	}
+#ifdef HAVE_MPI_PARTITIONED
+	if (Interface<C>::mpi_psend_init.hasSymbol())
+		return true;
+#endif
+	ErrorHandler::fail("The MPI library does not support partitioned communication");
+	return false;
+}
+
+//! \brief Get the ticket manager of a partitioned request
+//!
+//! \param request The partitioned request
+//!
+//! \returns The ticket manager of the shard of its communicator
+static TicketManager<C> &getPartitionedManager(MPI_Request request)
+{
+	PersistentRequests::Info info = PersistentRequests::get(request);
+	if (info.kind != PersistentRequests::Partitioned)
+		ErrorHandler::fail("Partitioned request not created through TAMPI");
+
+	return TicketManager<C>::getByComm(info.comm);
+}
+
+#pragma GCC visibility push(default)
+
+extern "C" {
+
+int TAMPI_Precv_init(void *buf, int partitions, MPI_Count count,
+		MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request)
+{
+	if (!checkPartitioned(__func__))
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+
+	int err = Interface<C>::mpi_precv_init(buf, partitions, count, datatype, source, tag, comm, info, request);
+	if (err == MPI_SUCCESS)
+		PersistentRequests::record(*request, comm, PersistentRequests::Partitioned);
+	return err;
+}
+
+int TAMPI_Psend_init(const void *buf, int partitions, MPI_Count count,
+		MPI_Datatype datatype, int dest, int tag, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request)
+{
+	if (!checkPartitioned(__func__))
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+
+	int err = Interface<C>::mpi_psend_init(buf, partitions, count, datatype, dest, tag, comm, info, request);
+	if (err == MPI_SUCCESS)
+		PersistentRequests::record(*request, comm, PersistentRequests::Partitioned);
+	return err;
+}
+
+int TAMPI_Pready(int partition, MPI_Request request)
+{
+	if (!checkPartitioned(__func__))
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	if (partition < 0)
+		return MPI_ERR_ARG;
+
+	getPartitionedManager(request).readyPartition(request, partition);
+	return MPI_SUCCESS;
+}
+
+int TAMPI_Parrived(MPI_Request request, int partition)
+{
+	if (!checkPartitioned(__func__))
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	if (partition < 0)
+		return MPI_ERR_ARG;
+
+	getPartitionedManager(request).waitPartition(request, partition);
+	return MPI_SUCCESS;
+}
+
+} // extern C
+
+#pragma GCC visibility pop
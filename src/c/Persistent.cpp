@@ -0,0 +1,152 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+
+#include <utility>
+#include <vector>
+
+#include "Declarations.hpp"
+#include "Environment.hpp"
+#include "Interface.hpp"
+#include "OperationManager.hpp"
+#include "PersistentRequests.hpp"
+#include "TAMPI_Wrappers.h"
+#include "TicketManager.hpp"
+
+using namespace tampi;
+
+//! \brief Build the start of a point-to-point persistent request
+//!
+//! The starts of the send requests carry their destination and size, so
+//! they are subject to the flow control like the rest of sends
+static Operation<C> makeStart(TaskingModel::task_handle_t task,
+	MPI_Request request, const PersistentRequests::Info &info, MPI_Status *status)
+{
+	if (info.kind == PersistentRequests::Send)
+		return Operation<C>(task, NONBLK, request, info.count, info.datatype, info.rank, info.comm, status);
+	return Operation<C>(task, NONBLK, request, info.comm, status);
+}
+
+#pragma GCC visibility push(default)
+
+extern "C" {
+
+int TAMPI_Recv_init(void *buf, int count, MPI_Datatype datatype, int source,
+		int tag, MPI_Comm comm, MPI_Request *request)
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+
+	int err = Interface<C>::mpi_recv_init(buf, count, datatype, source, tag, comm, request);
+	if (err == MPI_SUCCESS)
+		PersistentRequests::record(*request, comm, PersistentRequests::PointToPoint);
+	return err;
+}
+
+int TAMPI_Send_init(const void *buf, int count, MPI_Datatype datatype,
+		int dest, int tag, MPI_Comm comm, MPI_Request *request)
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+
+	// Keep the destination and the size of the message for the flow control
+	int err = Interface<C>::mpi_send_init(buf, count, datatype, dest, tag, comm, request);
+	if (err == MPI_SUCCESS)
+		PersistentRequests::record(*request, comm, PersistentRequests::Send, dest, count, datatype);
+	return err;
+}
+
+int TAMPI_Start(MPI_Request *request, MPI_Status *status)
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+	if (*request == MPI_REQUEST_NULL)
+		return MPI_ERR_REQUEST;
+
+	PersistentRequests::Info info = PersistentRequests::get(*request);
+
+	// The polling task starts the request and tracks it until completion,
+	// except the partitioned requests, which are started directly
+	if (info.kind == PersistentRequests::Partitioned) {
+		TicketManager<C>::getByComm(info.comm).startPartitioned(*request);
+	} else if (info.kind == PersistentRequests::Collective) {
+		OperationManager<C, CollOperation>::process(START, NONBLK, info.comm, *request);
+	} else {
+		OperationManager<C, Operation>::processBatch(1,
+			[&](TaskingModel::task_handle_t task, int) {
+				return makeStart(task, *request, info, status);
+			});
+	}
+	return MPI_SUCCESS;
+}
+
+int TAMPI_Startall(int count, MPI_Request requests[], MPI_Status statuses[])
+{
+	if (!Environment::isNonBlockingEnabled()) {
+		ErrorHandler::fail(__func__, " not enabled");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+	}
+	if (count < 0)
+		return MPI_ERR_COUNT;
+
+	for (int r = 0; r < count; ++r) {
+		if (requests[r] == MPI_REQUEST_NULL)
+			return MPI_ERR_REQUEST;
+	}
+
+	// Start the partitioned requests directly and the collective requests in
+	// order through the collective queues, and keep the positions of the
+	// point-to-point ones
+	std::vector<std::pair<int, PersistentRequests::Info>> p2p;
+	p2p.reserve(count);
+
+	for (int r = 0; r < count; ++r) {
+		PersistentRequests::Info info = PersistentRequests::get(requests[r]);
+		if (info.kind == PersistentRequests::Partitioned)
+			TicketManager<C>::getByComm(info.comm).startPartitioned(requests[r]);
+		else if (info.kind == PersistentRequests::Collective)
+			OperationManager<C, CollOperation>::process(START, NONBLK, info.comm, requests[r]);
+		else
+			p2p.emplace_back(r, info);
+	}
+
+	const bool ignoreStatuses = (statuses == MPI_STATUSES_IGNORE);
+
+	// Start the point-to-point requests in a single batch
+	OperationManager<C, Operation>::processBatch((int) p2p.size(),
+		[&](TaskingModel::task_handle_t task, int o) {
+			auto &[r, info] = p2p[o];
+			MPI_Status *status = (ignoreStatuses) ? MPI_STATUS_IGNORE : &statuses[r];
+			return makeStart(task, requests[r], info, status);
+		});
+	return MPI_SUCCESS;
+}
+
+int TAMPI_Request_free(MPI_Request *request)
+{
+	// Forget the request before MPI can reuse its handle
+	PersistentRequests::Info info;
+	if (*request != MPI_REQUEST_NULL && PersistentRequests::erase(*request, info)) {
+		// The partitioned requests may still be checked by the polling task
+		if (info.kind == PersistentRequests::Partitioned) {
+			TicketManager<C>::getByComm(info.comm).freePartitioned(*request);
+			return MPI_SUCCESS;
+		}
+	}
+
+	return Interface<C>::mpi_request_free(request);
+}
+
+} // extern C
+
+#pragma GCC visibility pop
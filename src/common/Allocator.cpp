@@ -1,30 +1,34 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2024-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #include "Allocator.hpp"
 #include "Declarations.hpp"
 #include "Operation.hpp"
+#include "util/EnvironmentVariable.hpp"
 
 
 namespace tampi {
 
 void Allocator::initialize()
 {
-	ObjAllocator<Operation<C>>::_instance =
-		new ObjAllocator<Operation<C>>(OperationCapacity);
+	EnvironmentVariable<size_t> collOperationCapacity("TAMPI_ALLOCATOR_COLL_OPERATIONS", DefaultCollOperationCapacity);
+
 	ObjAllocator<CollOperation<C>>::_instance =
-		new ObjAllocator<CollOperation<C>>(CollOperationCapacity);
+		new ObjAllocator<CollOperation<C>>(collOperationCapacity);
 }
 
 void Allocator::finalize()
 {
-	delete ObjAllocator<Operation<C>>::_instance;
 	delete ObjAllocator<CollOperation<C>>::_instance;
-	ObjAllocator<Operation<C>>::_instance = nullptr;
 	ObjAllocator<CollOperation<C>>::_instance = nullptr;
 }
 
+void Allocator::reportStats()
+{
+	report("collective operations", *ObjAllocator<CollOperation<C>>::_instance);
+}
+
 } // namespace tampi
@@ -1,59 +1,184 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2024-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef ALLOCATOR_HPP
 #define ALLOCATOR_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
+#include "Backpressure.hpp"
+#include "Interface.hpp"
 #include "TaskingModel.hpp"
-#include "util/FixedSizeStack.hpp"
+#include "util/Clock.hpp"
+#include "util/EnvironmentVariable.hpp"
 #include "util/SpinLock.hpp"
 #include "util/Utils.hpp"
 
-#include <boost/lockfree/spsc_queue.hpp>
+#include <boost/lockfree/stack.hpp>
 
 
 namespace tampi {
 
 //! Class that implements an object allocator. The allocator is suitable for
-//! scenarios where multiple CPUs will demand memory objects. The allocator
-//! maintains a SPSC queue with all the pre-allocated objects. Each CPU has
-//! a small cache where holds some objects. Initially, the caches are empty,
-//! so the consumers have to retrieve some objects from the SPSC queue and
-//! temporarily store them into the cache. There should only be one entity
-//! freeing objects, which returns the objects back to the SPSC queue
+//! scenarios where multiple CPUs will demand memory objects. The free objects
+//! are grouped in magazines of a fixed number of objects. Each CPU has a cache
+//! with a loaded magazine, from which it allocates, and a previous magazine.
+//! When both are empty, the CPU exchanges its empty magazine for a full one
+//! from a lock-free depot, so the steady-state allocation path takes no lock.
+//! The entities freeing objects, i.e., the polling tasks, fill magazines with
+//! the freed objects and publish them into the depot once they are full. The
+//! objects are stored in slabs that are allocated on demand when the depot
+//! runs out of objects, up to a maximum number of objects. The slabs whose
+//! objects stay free in the depot for some time are released, keeping a slab
+//! of free objects as reserve
 template <typename T>
 class ObjAllocator {
 	typedef Padded<T> Data;
-	typedef boost::lockfree::spsc_queue<T *, boost::lockfree::fixed_sized<true>> Queue;
 
-	static constexpr size_t MaxCaches = MaxSystemCPUs;
-	static constexpr size_t BatchSize = 64;
+	//! The number of objects per magazine
+	static constexpr size_t MagazineSize = 64;
 
-	//! The number of objects
-	alignas(CacheAlignment) const size_t _capacity;
+	//! The minimum number of objects per slab
+	static constexpr size_t SlabSize = 1024;
+
+	//! The number of depot entries reserved initially; the depots
+	//! grow on demand
+	static constexpr size_t InitialMagazines = SlabSize / MagazineSize;
+
+	//! The time (in ms) that the free objects must exceed the reserve before
+	//! releasing the idle slabs
+	static constexpr double IdleTime = 100;
+
+	//! Structure that represents a magazine of free objects
+	struct Magazine {
+		//! The number of objects
+		size_t count;
+
+		//! The objects
+		T *objects[MagazineSize];
+
+		Magazine() : count(0)
+		{
+		}
+	};
+
+	//! Structure that represents the cache of a CPU
+	struct Cache {
+		//! The magazine from which objects are allocated
+		Magazine *loaded;
+
+		//! The previously loaded magazine
+		Magazine *previous;
+
+		Cache() : loaded(nullptr), previous(nullptr)
+		{
+		}
+	};
+
+	typedef boost::lockfree::stack<Magazine *> Depot;
+
+	//! Structure that represents a slab of objects
+	struct Slab {
+		//! The pointer to the array of padded objects
+		Data *data;
+
+		//! The number of objects
+		size_t count;
+
+		//! The number of free objects; only valid while trimming
+		size_t nfree;
+
+		//! Whether the slab is released; only valid while trimming
+		bool idle;
+	};
+
+public:
+	//! Structure that holds the allocator statistics
+	struct Stats {
+		//! The maximum number of objects
+		size_t limit;
+
+		//! The current number of objects and slabs
+		size_t objects;
+		size_t slabs;
+
+		//! The peak number of objects
+		size_t peakObjects;
+
+		//! The number of allocated and released slabs
+		size_t grown;
+		size_t released;
+
+		//! The number of times the allocator was found exhausted
+		size_t exhausted;
+	};
+
+private:
+	//! The maximum number of objects
+	alignas(CacheAlignment) const size_t _limit;
 
 	//! The number of caches (one per CPU)
 	const size_t _ncaches;
 
-	//! The pointer to the array of padded objects
-	Data *_data;
+	//! The number of objects per slab
+	const size_t _slabSize;
+
+	//! The current number of objects
+	std::atomic<size_t> _nobjects;
+
+	//! The slabs sorted by address; protected by the slab spinlock
+	std::vector<Slab> _slabs;
+
+	//! The statistics; protected by the slab spinlock
+	Stats _stats;
+
+	//! The number of times the allocator was found exhausted
+	std::atomic<size_t> _exhausted;
+
+	//! The magazine being filled by the polling tasks; protected by the
+	//! free spinlock
+	Magazine *_filling;
+
+	//! The timestamp (in ms) since the free objects exceed the reserve or
+	//! zero otherwise; protected by the free spinlock
+	double _idleSince;
+
+	//! All the allocated magazines; protected by the magazine spinlock
+	std::vector<Magazine *> _magazines;
 
 	//! The caches: one per CPU
-	alignas(CacheAlignment) PaddedArray<FixedSizeStack<T *, BatchSize>, MaxCaches> _caches;
+	alignas(CacheAlignment) PaddedArray<Cache> _caches;
+
+	//! The depot of full magazines
+	alignas(CacheAlignment) Depot _fullMagazines;
 
-	//! The central SPSC queue
-	alignas(CacheAlignment) Queue _central;
+	//! The number of full magazines in the depot
+	std::atomic<size_t> _nfullMagazines;
 
-	//! The spinlock used to access the consumer side of the SPSC queue
+	//! The depot of empty magazines
+	alignas(CacheAlignment) Depot _emptyMagazines;
+
+	//! The spinlock used to grow and trim the slabs
 	alignas(CacheAlignment) SpinLock _mutex;
 
+	//! The spinlock used by the polling tasks to free objects
+	alignas(CacheAlignment) SpinLock _freeMutex;
+
+	//! The spinlock used to register new magazines
+	alignas(CacheAlignment) SpinLock _magazinesMutex;
+
+	//! The backpressure applied to the tasks when there are no objects
+	alignas(CacheAlignment) Backpressure _backpressure;
+
 protected:
 	friend class Allocator;
 
@@ -63,25 +188,38 @@ protected:
 public:
 	//! \brief Constructs an allocator
 	//!
-	//! \param capacity The number of objects to allocate
-	ObjAllocator(size_t capacity) :
-		_capacity(capacity),
+	//! No object is allocated until the first allocation
+	//!
+	//! \param limit The maximum number of objects
+	ObjAllocator(size_t limit) :
+		_limit(limit),
 		_ncaches(TaskingModel::getNumLogicalCPUs()),
-		_data(Memory::alignedAlloc<Data>(capacity)),
-		_caches(),
-		_central(capacity)
+		_slabSize(Memory::getPreferredCount<Data>(SlabSize)),
+		_nobjects(0),
+		_slabs(),
+		_stats(),
+		_exhausted(0),
+		_filling(nullptr),
+		_idleSince(0),
+		_magazines(),
+		_caches(_ncaches),
+		_fullMagazines(InitialMagazines),
+		_nfullMagazines(0),
+		_emptyMagazines(InitialMagazines)
 	{
-		if (_ncaches > MaxCaches)
-			ErrorHandler::fail(__func__, ": Maximum number of queues exceeded. Runtime got: ", _ncaches, ", TAMPI was compiled with maximum: ", MaxCaches);
+		if (_limit == 0)
+			ErrorHandler::fail(__func__, ": The maximum number of objects cannot be zero");
 
-		for (size_t o = 0; o < _capacity; ++o)
-			_central.push(&(_data[o].get()));
+		_stats.limit = _limit;
 	}
 
 	//! \brief Destroys an allocator
 	~ObjAllocator()
 	{
-		Memory::alignedFree<Data>(_data, _capacity);
+		for (Magazine *magazine : _magazines)
+			delete magazine;
+		for (Slab &slab : _slabs)
+			Memory::alignedFree<Data>(slab.data, slab.count);
 	}
 
 	//! \brief Allocates and constructs an object
@@ -92,26 +230,19 @@ public:
 	template <typename... Args>
 	T *alloc(Args &&... args)
 	{
-		T *object = nullptr;
-
-		size_t cache = TaskingModel::getCurrentLogicalCPU();
-		assert(cache < _ncaches);
-
-		if (!_caches[cache].pop(object)) {
-			T *objects[BatchSize];
-
-			_mutex.lock();
-			size_t n = _central.pop(objects, BatchSize);
-			_mutex.unlock();
-
-			if (n == 0)
-				ErrorHandler::fail("Unavailable allocator objects");
-
-			if (n > 1)
-				_caches[cache].push(&objects[1], n-1);
-
-			object = objects[0];
+		size_t cpu = TaskingModel::getCurrentLogicalCPU();
+		assert(cpu < _ncaches);
+
+		Cache &cache = _caches[cpu];
+		if (cache.loaded == nullptr || cache.loaded->count == 0) {
+			if (cache.previous != nullptr && cache.previous->count > 0)
+				std::swap(cache.loaded, cache.previous);
+			else
+				reload(cache);
 		}
+		assert(cache.loaded->count > 0);
+
+		T *object = cache.loaded->objects[--cache.loaded->count];
 		assert(object != nullptr);
 
 		new (object) T(std::forward<Args>(args)...);
@@ -120,9 +251,9 @@ public:
 
 	//! \brief Frees several objects
 	//!
-	//! This operation must be executed by a single entity, i.e., the polling
-	//! task. Calling this function from other entities is invalid. See the
-	//! 'localFree' operation instead
+	//! This operation must be executed by the polling tasks. Calling this
+	//! function from other entities is invalid. See the 'localFree' operation
+	//! instead
 	//!
 	//! \param objects The objects to free
 	//! \param n The number of objects to free
@@ -131,9 +262,25 @@ public:
 		for (size_t o = 0; o < n; ++o)
 			objects[o]->~T();
 
-		[[maybe_unused]] size_t pushed;
-		pushed = _central.push(objects, n);
-		assert(pushed == n);
+		_freeMutex.lock();
+		for (size_t o = 0; o < n; ++o) {
+			if (_filling == nullptr)
+				_filling = getEmptyMagazine();
+
+			_filling->objects[_filling->count++] = objects[o];
+			if (_filling->count == MagazineSize) {
+				pushFullMagazine(_filling);
+				_filling = nullptr;
+			}
+		}
+		bool idle = checkIdle();
+		_freeMutex.unlock();
+
+		if (Backpressure::isEnabled())
+			_backpressure.release();
+
+		if (idle)
+			trim();
 	}
 
 	//! \brief Frees several objects into the local cache
@@ -145,10 +292,290 @@ public:
 		for (size_t o = 0; o < n; ++o)
 			objects[o]->~T();
 
-		size_t cache = TaskingModel::getCurrentLogicalCPU();
-		assert(cache < _ncaches);
+		size_t cpu = TaskingModel::getCurrentLogicalCPU();
+		assert(cpu < _ncaches);
+
+		Cache &cache = _caches[cpu];
+		for (size_t o = 0; o < n; ++o) {
+			if (cache.loaded == nullptr) {
+				cache.loaded = getEmptyMagazine();
+			} else if (cache.loaded->count == MagazineSize) {
+				if (cache.previous != nullptr && cache.previous->count == 0) {
+					std::swap(cache.loaded, cache.previous);
+				} else {
+					// Publish the previous magazine if it has objects
+					if (cache.previous != nullptr)
+						pushFullMagazine(cache.previous);
+					cache.previous = cache.loaded;
+					cache.loaded = getEmptyMagazine();
+				}
+			}
+			cache.loaded->objects[cache.loaded->count++] = objects[o];
+		}
+	}
+
+	//! \brief Get the allocator statistics
+	//!
+	//! \returns The statistics
+	Stats getStats()
+	{
+		std::lock_guard<SpinLock> guard(_mutex);
+
+		Stats stats = _stats;
+		stats.objects = _nobjects.load(std::memory_order_relaxed);
+		stats.slabs = _slabs.size();
+		stats.exhausted = _exhausted.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+private:
+	//! \brief Exchange the empty loaded magazine of a cache for a full one
+	//!
+	//! \param cache The cache of the current CPU
+	void reload(Cache &cache)
+	{
+		Magazine *magazine = popFullMagazine();
+		if (magazine == nullptr) {
+			magazine = refill();
+			if (magazine == nullptr) {
+				_exhausted.fetch_add(1, std::memory_order_relaxed);
+
+				if (Backpressure::isEnabled()) {
+					// Wait until the polling tasks free objects
+					_backpressure.waitUntil([&]() {
+						magazine = refill();
+						return (magazine != nullptr);
+					});
+				}
+			}
+
+			if (magazine == nullptr)
+				ErrorHandler::fail("Unavailable allocator objects (maximum ", _limit, ")");
+		}
+
+		if (cache.loaded != nullptr)
+			_emptyMagazines.push(cache.loaded);
+		cache.loaded = magazine;
+	}
+
+	//! \brief Retrieve a full magazine when the depot is found empty
+	//!
+	//! A new slab is allocated if the maximum number of objects was not
+	//! reached. Otherwise, the magazine being filled by the polling tasks
+	//! is taken even if it is not full
+	//!
+	//! \returns A magazine with objects or nullptr if there are none
+	Magazine *refill()
+	{
+		std::lock_guard<SpinLock> guard(_mutex);
+
+		Magazine *magazine = popFullMagazine();
+		if (magazine != nullptr)
+			return magazine;
+
+		if (grow())
+			return popFullMagazine();
+
+		_freeMutex.lock();
+		if (_filling != nullptr && _filling->count > 0) {
+			magazine = _filling;
+			_filling = nullptr;
+		}
+		_freeMutex.unlock();
+
+		return magazine;
+	}
+
+	//! \brief Allocate a new slab and publish its objects in magazines
+	//!
+	//! The slab spinlock must be held
+	//!
+	//! \returns Whether a slab was allocated
+	bool grow()
+	{
+		size_t nobjects = _nobjects.load(std::memory_order_relaxed);
+		if (nobjects >= _limit)
+			return false;
+
+		Slab slab;
+		slab.count = std::min(_slabSize, _limit - nobjects);
+
+		// Place the slab close to the producer CPU growing it
+		slab.data = Memory::alignedAlloc<Data>(slab.count, Memory::getCurrentNode());
+		slab.nfree = 0;
+		slab.idle = false;
+
+		auto it = std::upper_bound(_slabs.begin(), _slabs.end(), slab,
+			[](const Slab &a, const Slab &b) { return a.data < b.data; });
+		_slabs.insert(it, slab);
+
+		for (size_t o = 0; o < slab.count; o += MagazineSize) {
+			Magazine *magazine = getEmptyMagazine();
+			magazine->count = std::min(MagazineSize, slab.count - o);
+			for (size_t m = 0; m < magazine->count; ++m)
+				magazine->objects[m] = &(slab.data[o + m].get());
+			pushFullMagazine(magazine);
+		}
+
+		nobjects += slab.count;
+		_nobjects.store(nobjects, std::memory_order_relaxed);
+
+		_stats.peakObjects = std::max(_stats.peakObjects, nobjects);
+		_stats.grown++;
+		return true;
+	}
+
+	//! \brief Check whether the idle slabs should be released
+	//!
+	//! The free spinlock must be held
+	//!
+	//! \returns Whether the free objects exceeded the reserve for a while
+	bool checkIdle()
+	{
+		size_t nfree = _nfullMagazines.load(std::memory_order_relaxed) * MagazineSize;
+		if (nfree < 2 * _slabSize) {
+			_idleSince = 0;
+			return false;
+		}
+
+		double now = Clock::now_ms();
+		if (_idleSince == 0) {
+			_idleSince = now;
+			return false;
+		} else if (now - _idleSince < IdleTime) {
+			return false;
+		}
 
-		_caches[cache].push(objects, n);
+		_idleSince = 0;
+		return true;
+	}
+
+	//! \brief Release the slabs whose objects are all free
+	//!
+	//! The depot is drained to find the slabs that have all their objects
+	//! free. The objects held by the CPU caches and the magazine being filled
+	//! keep their slabs allocated. The rest of free objects are published
+	//! again in magazines
+	void trim()
+	{
+		std::lock_guard<SpinLock> guard(_mutex);
+
+		std::vector<T *> objects;
+		objects.reserve(_nobjects.load(std::memory_order_relaxed));
+
+		Magazine *magazine;
+		while ((magazine = popFullMagazine()) != nullptr) {
+			objects.insert(objects.end(), magazine->objects, magazine->objects + magazine->count);
+			magazine->count = 0;
+			_emptyMagazines.push(magazine);
+		}
+
+		// Count the free objects of each slab
+		for (Slab &slab : _slabs)
+			slab.nfree = 0;
+		for (T *object : objects)
+			findSlab(object).nfree++;
+
+		// Release the idle slabs while keeping a slab of free objects
+		size_t reserve = objects.size();
+		size_t released = 0;
+		for (Slab &slab : _slabs) {
+			slab.idle = (slab.nfree == slab.count && reserve - slab.count >= _slabSize);
+			if (slab.idle) {
+				reserve -= slab.count;
+				released += slab.count;
+			}
+		}
+
+		// Publish again the objects of the remaining slabs
+		magazine = nullptr;
+		for (T *object : objects) {
+			if (released > 0 && findSlab(object).idle)
+				continue;
+
+			if (magazine == nullptr)
+				magazine = getEmptyMagazine();
+
+			magazine->objects[magazine->count++] = object;
+			if (magazine->count == MagazineSize) {
+				pushFullMagazine(magazine);
+				magazine = nullptr;
+			}
+		}
+		if (magazine != nullptr)
+			pushFullMagazine(magazine);
+
+		if (released == 0)
+			return;
+
+		auto it = _slabs.begin();
+		while (it != _slabs.end()) {
+			if (it->idle) {
+				Memory::alignedFree<Data>(it->data, it->count);
+				it = _slabs.erase(it);
+				_stats.released++;
+			} else {
+				++it;
+			}
+		}
+		_nobjects.fetch_sub(released, std::memory_order_relaxed);
+	}
+
+	//! \brief Find the slab containing an object
+	//!
+	//! \param object The object
+	//!
+	//! \returns The slab
+	Slab &findSlab(const T *object)
+	{
+		auto it = std::upper_bound(_slabs.begin(), _slabs.end(), object,
+			[](const T *ptr, const Slab &slab) { return (uintptr_t) ptr < (uintptr_t) slab.data; });
+		assert(it != _slabs.begin());
+		--it;
+		return *it;
+	}
+
+	//! \brief Get an empty magazine from the depot or allocate a new one
+	//!
+	//! \returns The empty magazine
+	Magazine *getEmptyMagazine()
+	{
+		Magazine *magazine;
+		if (_emptyMagazines.pop(magazine)) {
+			assert(magazine->count == 0);
+			return magazine;
+		}
+
+		magazine = new Magazine();
+
+		std::lock_guard<SpinLock> guard(_magazinesMutex);
+		_magazines.push_back(magazine);
+		return magazine;
+	}
+
+	//! \brief Publish a magazine with objects into the depot
+	//!
+	//! \param magazine The magazine
+	void pushFullMagazine(Magazine *magazine)
+	{
+		assert(magazine->count > 0);
+
+		// Count it before pushing so the counter never underflows
+		_nfullMagazines.fetch_add(1, std::memory_order_relaxed);
+		_fullMagazines.push(magazine);
+	}
+
+	//! \brief Get a magazine with objects from the depot
+	//!
+	//! \returns The magazine or nullptr if the depot is empty
+	Magazine *popFullMagazine()
+	{
+		Magazine *magazine;
+		if (!_fullMagazines.pop(magazine))
+			return nullptr;
+
+		_nfullMagazines.fetch_sub(1, std::memory_order_relaxed);
+		return magazine;
 	}
 };
 
@@ -157,8 +584,24 @@ ObjAllocator<T> *ObjAllocator<T>::_instance = nullptr;
 
 //! Class that encapsulates all allocators
 class Allocator {
-	static constexpr size_t OperationCapacity = 64*1000;
-	static constexpr size_t CollOperationCapacity = 8*1000;
+	//! The default maximum number of collective operations. The point-to-point
+	//! operations are stored by value in the ticket manager queues
+	static constexpr size_t DefaultCollOperationCapacity = 8*1000;
+
+	//! \brief Report the statistics of an allocator
+	//!
+	//! \param name The name of the allocated objects
+	//! \param allocator The allocator
+	template <typename T>
+	static void report(const char *name, ObjAllocator<T> &allocator)
+	{
+		typename ObjAllocator<T>::Stats stats = allocator.getStats();
+		ErrorHandler::info("Allocator of ", name, " in rank ", InterfaceAny::rank,
+			": limit=", stats.limit, " objects=", stats.objects,
+			" peak=", stats.peakObjects, " slabs=", stats.slabs,
+			" grown=", stats.grown, " released=", stats.released,
+			" exhausted=", stats.exhausted);
+	}
 
 public:
 	//! \brief Initialize all the allocators
@@ -167,6 +610,9 @@ public:
 	//! \brief Finalize all the allocators
 	static void finalize();
 
+	//! \brief Report the statistics of all the allocators
+	static void reportStats();
+
 	//! \brief Allocates and constructs an object
 	//!
 	//! \param args The arguments for constructing the object
@@ -181,8 +627,8 @@ public:
 
 	//! \brief Frees several objects
 	//!
-	//! This operation must be executed by a single entity, i.e., the polling
-	//! task. Calling this function from other entities is invalid
+	//! This operation must be executed by the polling tasks. Calling this
+	//! function from other entities is invalid
 	//!
 	//! \param objects The objects to free
 	//! \param n The number of objects to free
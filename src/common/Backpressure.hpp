@@ -0,0 +1,128 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef BACKPRESSURE_HPP
+#define BACKPRESSURE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "TaskingModel.hpp"
+#include "util/EnvironmentVariable.hpp"
+#include "util/SpinLock.hpp"
+#include "util/SpinWait.hpp"
+
+
+namespace tampi {
+
+//! Class that applies backpressure to the tasks producing work for a bounded
+//! resource, such as a queue or an object pool, that is exhausted. Instead of
+//! spinning or aborting, the producer task is blocked until the consumer frees
+//! space and resumes it. This releases the CPUs that the polling tasks need to
+//! drain the resource. If the blocking API is not available, the producer task
+//! waits for increasing amounts of time, and threads outside tasks spin
+class Backpressure {
+private:
+	//! The initial and maximum waiting times (in ns) without blocking API
+	static constexpr uint64_t MinWaitTime = 1000;
+	static constexpr uint64_t MaxWaitTime = 1000000;
+
+	//! Whether the backpressure is enabled
+	static EnvironmentVariable<bool> _enabled;
+
+	//! The spinlock protecting the waiting tasks
+	SpinLock _mutex;
+
+	//! The tasks waiting for space
+	std::vector<TaskingModel::task_handle_t> _waiters;
+
+	//! The number of tasks waiting for space
+	std::atomic<size_t> _nwaiters;
+
+public:
+	Backpressure() :
+		_mutex(),
+		_waiters(),
+		_nwaiters(0)
+	{
+	}
+
+	Backpressure(const Backpressure &) = delete;
+	const Backpressure& operator= (const Backpressure &) = delete;
+
+	//! \brief Indicate whether the backpressure is enabled
+	static bool isEnabled()
+	{
+		return _enabled;
+	}
+
+	//! \brief Wait until a condition holds
+	//!
+	//! The condition is usually an attempt to acquire space in the resource,
+	//! and it is evaluated again each time the task is resumed
+	//!
+	//! \param condition The condition to wait for
+	template <typename Condition>
+	void waitUntil(Condition condition)
+	{
+		TaskingModel::task_handle_t task = nullptr;
+		if (TaskingModel::isTaskWaitingAvailable())
+			task = TaskingModel::getCurrentTask();
+
+		uint64_t waitTime = MinWaitTime;
+		while (!condition()) {
+			if (task == nullptr) {
+				SpinWait::wait();
+			} else if (!TaskingModel::isTaskBlockingAvailable()) {
+				TaskingModel::waitCurrentTask(waitTime);
+				waitTime = std::min(waitTime * 2, MaxWaitTime);
+			} else {
+				_mutex.lock();
+				_waiters.push_back(task);
+				_nwaiters.fetch_add(1);
+				_mutex.unlock();
+
+				// The space may have been freed before registering. An
+				// early unblock makes the block below return immediately
+				if (condition()) {
+					release();
+					TaskingModel::blockCurrentTask(task);
+					break;
+				}
+				TaskingModel::blockCurrentTask(task);
+			}
+		}
+		SpinWait::release();
+	}
+
+	//! \brief Resume the waiting tasks after freeing space
+	//!
+	//! This function must be called by the consumer after freeing space
+	void release()
+	{
+		// Order the freed space before checking the waiters
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (_nwaiters.load(std::memory_order_relaxed) == 0)
+			return;
+
+		std::vector<TaskingModel::task_handle_t> waiters;
+
+		_mutex.lock();
+		waiters.swap(_waiters);
+		_nwaiters.store(0, std::memory_order_relaxed);
+		_mutex.unlock();
+
+		for (TaskingModel::task_handle_t task : waiters)
+			TaskingModel::unblockTask(task);
+	}
+};
+
+} // namespace tampi
+
+#endif // BACKPRESSURE_HPP
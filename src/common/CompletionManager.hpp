@@ -1,13 +1,15 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef COMPLETION_MANAGER_HPP
 #define COMPLETION_MANAGER_HPP
 
+#include <cassert>
 #include <cstdint>
+#include <vector>
 
 #include <boost/version.hpp>
 
@@ -19,6 +21,7 @@
 #include <boost/lockfree/spsc_queue.hpp>
 
 #include "TaskContext.hpp"
+#include "TaskingModel.hpp"
 #include "instrument/Instrument.hpp"
 #include "util/EnvironmentVariable.hpp"
 #include "util/ErrorHandler.hpp"
@@ -34,32 +37,120 @@ private:
 
 	static EnvironmentVariable<bool> _enabled;
 
-	static queue_t _queue;
+	//! The queues of completed task contexts; one per shard
+	static queue_t *_queues;
+
+	//! The number of queues
+	static size_t _nqueues;
+
+	//! The completed task contexts that did not fit in the queues; one per
+	//! shard and only accessed by its producer
+	static std::vector<TaskContext> *_overflows;
+
+	//! The polling instance of the task that processes completions
+	static TaskingModel::PollingInstance *_pollingInstance;
 
 public:
 	CompletionManager() = delete;
 	CompletionManager(const CompletionManager &) = delete;
 	const CompletionManager& operator= (const CompletionManager &) = delete;
 
-	static void transfer(const TaskContext *contexts, size_t count)
+	//! \brief Initialize the completion queues
+	//!
+	//! \param nqueues The number of queues, one per producer
+	static void initialize(size_t nqueues)
+	{
+		assert(_queues == nullptr);
+
+		_queues = new queue_t[nqueues];
+		_overflows = new std::vector<TaskContext>[nqueues];
+		_nqueues = nqueues;
+	}
+
+	//! \brief Set the polling instance to notify when there are completions
+	//!
+	//! \param instance The polling instance
+	static void setPollingInstance(TaskingModel::PollingInstance *instance)
+	{
+		_pollingInstance = instance;
+	}
+
+	//! \brief Finalize the completion queues
+	static void finalize()
+	{
+		delete[] _queues;
+		delete[] _overflows;
+		_queues = nullptr;
+		_overflows = nullptr;
+		_nqueues = 0;
+	}
+
+	//! \brief Transfer completed task contexts to a queue
+	//!
+	//! Each queue must be fed by a single producer. The task contexts that do
+	//! not fit in the queue are kept by the producer until there is room, so
+	//! the number of completions is not limited by the queue size
+	//!
+	//! \param queue The queue index
+	//! \param contexts The task contexts
+	//! \param count The number of task contexts
+	static void transfer(size_t queue, const TaskContext *contexts, size_t count)
 	{
-		size_t pushed = _queue.push(contexts, count);
+		assert(queue < _nqueues);
+
+		std::vector<TaskContext> &overflow = _overflows[queue];
+
+		// Keep the completion order behind the overflowed contexts
+		size_t pushed = 0;
+		if (overflow.empty() || flush(queue) == 0)
+			pushed = _queues[queue].push(contexts, count);
+
 		if (pushed != count)
-			ErrorHandler::fail("Failed to push task contexts");
+			overflow.insert(overflow.end(), contexts + pushed, contexts + count);
+
+		TaskingModel::notifyPolling(_pollingInstance);
 	}
 
-	static size_t process()
+	//! \brief Move the overflowed task contexts of a queue to the queue
+	//!
+	//! This function must be called by the producer of the queue
+	//!
+	//! \param queue The queue index
+	//!
+	//! \returns The number of task contexts that are still overflowed
+	static size_t flush(size_t queue)
 	{
-		if (!_queue.read_available())
+		assert(queue < _nqueues);
+
+		std::vector<TaskContext> &overflow = _overflows[queue];
+		if (overflow.empty())
 			return 0;
 
-		Instrument::Guard<CompletedRequest> instrGuard;
+		size_t pushed = _queues[queue].push(overflow.data(), overflow.size());
+		if (pushed > 0) {
+			overflow.erase(overflow.begin(), overflow.begin() + pushed);
+			TaskingModel::notifyPolling(_pollingInstance);
+		}
+		return overflow.size();
+	}
+
+	static size_t process()
+	{
+		size_t completed = 0;
+
+		for (size_t q = 0; q < _nqueues; ++q) {
+			if (!_queues[q].read_available())
+				continue;
+
+			Instrument::Guard<CompletedRequest> instrGuard;
 
-		// Complete all task contexts
-		return _queue.consume_all(
-			[&]<typename T>(T &&context) {
-				std::forward<T>(context).completeEvents(1, true);
-			});
+			// Complete all task contexts
+			completed += _queues[q].consume_all(
+				[&]<typename T>(T &&context) {
+					std::forward<T>(context).completeEvents(1, true);
+				});
+		}
+		return completed;
 	}
 
 	static bool isEnabled()
@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef DECLARATIONS_HPP
@@ -13,6 +13,12 @@
 
 #include <Symbol.hpp>
 
+//! The prefix of the C persistent collectives, which is detected at configure
+//! time. Open MPI provides them as an extension with the MPIX_ prefix
+#ifndef MPI_PERSISTENT_COLLECTIVES_C_PREFIX
+#define MPI_PERSISTENT_COLLECTIVES_C_PREFIX "MPI_"
+#endif
+
 namespace tampi {
 
 //! Classes representing C/C++ and Fortran languages. The MPI interface
@@ -34,6 +40,7 @@ struct Prototypes<C> {
 	using mpi_comm_rank_t = SymbolDecl<int, MPI_Comm, int*>;
 	using mpi_comm_size_t = SymbolDecl<int, MPI_Comm, int*>;
 	using mpi_query_thread_t = SymbolDecl<int, int*>;
+	using mpi_type_size_t = SymbolDecl<int, MPI_Datatype, int*>;
 
 	//! Request waiting/testing operations in C
 	using mpi_test_t = SymbolDecl<int, MPI_Request*, int*, MPI_Status*>;
@@ -59,6 +66,18 @@ struct Prototypes<C> {
 	using mpi_issend_t = SymbolDecl<int, const void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request*>;
 	using mpi_isend_t = SymbolDecl<int, const void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request*>;
 
+	//! Point-to-point persistent operations in C
+	using mpi_recv_init_t = SymbolDecl<int, void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request*>;
+	using mpi_send_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request*>;
+	using mpi_start_t = SymbolDecl<int, MPI_Request*>;
+	using mpi_request_free_t = SymbolDecl<int, MPI_Request*>;
+
+	//! Point-to-point partitioned operations in C
+	using mpi_precv_init_t = SymbolDecl<int, void*, int, MPI_Count, MPI_Datatype, int, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_psend_init_t = SymbolDecl<int, const void*, int, MPI_Count, MPI_Datatype, int, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_pready_t = SymbolDecl<int, int, MPI_Request>;
+	using mpi_parrived_t = SymbolDecl<int, MPI_Request, int, int*>;
+
 	//! Collective blocking operations in C
 	using mpi_allgather_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, int, MPI_Datatype, MPI_Comm>;
 	using mpi_allgatherv_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, const int[], const int[], MPI_Datatype, MPI_Comm>;
@@ -96,6 +115,25 @@ struct Prototypes<C> {
 	using mpi_iscatterv_t = SymbolDecl<int, const void*, const int[], const int[], MPI_Datatype, void*, int, MPI_Datatype, int, MPI_Comm, MPI_Request*>;
 	using mpi_iscan_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Request*>;
 	using mpi_iexscan_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Request*>;
+
+	//! Collective persistent operations in C
+	using mpi_allgather_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, int, MPI_Datatype, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_allgatherv_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, const int[], const int[], MPI_Datatype, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_allreduce_init_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_alltoall_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, int, MPI_Datatype, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_alltoallv_init_t = SymbolDecl<int, const void*, const int[], const int[], MPI_Datatype, void*, const int[], const int[], MPI_Datatype, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_alltoallw_init_t = SymbolDecl<int, const void*, const int[], const int[], const MPI_Datatype[], void*, const int[], const int[], const MPI_Datatype[], MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_barrier_init_t = SymbolDecl<int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_bcast_init_t = SymbolDecl<int, void*, int, MPI_Datatype, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_exscan_init_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_gather_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, int, MPI_Datatype, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_gatherv_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, const int[], const int[], MPI_Datatype, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_reduce_init_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_reduce_scatter_init_t = SymbolDecl<int, const void*, void*, const int[], MPI_Datatype, MPI_Op, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_reduce_scatter_block_init_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_scan_init_t = SymbolDecl<int, const void*, void*, int, MPI_Datatype, MPI_Op, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_scatter_init_t = SymbolDecl<int, const void*, int, MPI_Datatype, void*, int, MPI_Datatype, int, MPI_Comm, MPI_Info, MPI_Request*>;
+	using mpi_scatterv_init_t = SymbolDecl<int, const void*, const int[], const int[], MPI_Datatype, void*, int, MPI_Datatype, int, MPI_Comm, MPI_Info, MPI_Request*>;
 };
 
 
@@ -108,6 +146,7 @@ struct Prototypes<Fortran> {
 	using mpi_comm_rank_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 	using mpi_comm_size_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 	using mpi_query_thread_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*>;
+	using mpi_type_size_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 
 	//! Request testing/waiting operations in Fortran
 	using mpi_test_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
@@ -133,6 +172,18 @@ struct Prototypes<Fortran> {
 	using mpi_isend_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 	using mpi_issend_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 
+	//! Point-to-point persistent operations in Fortran
+	using mpi_recv_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_send_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_start_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*>;
+	using mpi_request_free_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*>;
+
+	//! Point-to-point partitioned operations in Fortran
+	using mpi_precv_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Count*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_psend_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Count*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_pready_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_parrived_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+
 	//! Collective blocking operations in Fortran
 	using mpi_allgather_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 	using mpi_allgatherv_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, MPI_Fint*, MPI_Fint*>;
@@ -170,6 +221,25 @@ struct Prototypes<Fortran> {
 	using mpi_iscatterv_t = SymbolDecl<void, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 	using mpi_iscan_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 	using mpi_iexscan_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+
+	//! Collective persistent operations in Fortran
+	using mpi_allgather_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_allgatherv_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_allreduce_init_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_alltoall_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_alltoallv_init_t = SymbolDecl<void, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_alltoallw_init_t = SymbolDecl<void, void*, MPI_Fint[], MPI_Fint[], MPI_Fint[], void*, MPI_Fint[], MPI_Fint[], MPI_Fint[], MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_barrier_init_t = SymbolDecl<void, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_bcast_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_exscan_init_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_gather_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_gatherv_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_reduce_init_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_reduce_scatter_init_t = SymbolDecl<void, void*, void*, MPI_Fint[], MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_reduce_scatter_block_init_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_scan_init_t = SymbolDecl<void, void*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_scatter_init_t = SymbolDecl<void, void*, MPI_Fint*, MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
+	using mpi_scatterv_init_t = SymbolDecl<void, void*, MPI_Fint[], MPI_Fint[], MPI_Fint*, void*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*, MPI_Fint*>;
 };
 
 template <typename Lang>
@@ -190,6 +260,18 @@ struct Names<C> {
 	static constexpr std::string_view mpi_issend = "MPI_Issend";
 	static constexpr std::string_view mpi_isend = "MPI_Isend";
 
+	//! Point-to-point persistent operations
+	static constexpr std::string_view mpi_recv_init = "MPI_Recv_init";
+	static constexpr std::string_view mpi_send_init = "MPI_Send_init";
+	static constexpr std::string_view mpi_start = "MPI_Start";
+	static constexpr std::string_view mpi_request_free = "MPI_Request_free";
+
+	//! Point-to-point partitioned operations
+	static constexpr std::string_view mpi_precv_init = "MPI_Precv_init";
+	static constexpr std::string_view mpi_psend_init = "MPI_Psend_init";
+	static constexpr std::string_view mpi_pready = "MPI_Pready";
+	static constexpr std::string_view mpi_parrived = "MPI_Parrived";
+
 	//! Collective non-blocking operations
 	static constexpr std::string_view mpi_iallgather = "MPI_Iallgather";
 	static constexpr std::string_view mpi_iallgatherv = "MPI_Iallgatherv";
@@ -209,10 +291,30 @@ struct Names<C> {
 	static constexpr std::string_view mpi_iscan = "MPI_Iscan";
 	static constexpr std::string_view mpi_iexscan = "MPI_Iexscan";
 
+	//! Collective persistent operations
+	static constexpr std::string_view mpi_allgather_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Allgather_init";
+	static constexpr std::string_view mpi_allgatherv_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Allgatherv_init";
+	static constexpr std::string_view mpi_allreduce_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Allreduce_init";
+	static constexpr std::string_view mpi_alltoall_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Alltoall_init";
+	static constexpr std::string_view mpi_alltoallv_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Alltoallv_init";
+	static constexpr std::string_view mpi_alltoallw_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Alltoallw_init";
+	static constexpr std::string_view mpi_barrier_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Barrier_init";
+	static constexpr std::string_view mpi_bcast_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Bcast_init";
+	static constexpr std::string_view mpi_exscan_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Exscan_init";
+	static constexpr std::string_view mpi_gather_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Gather_init";
+	static constexpr std::string_view mpi_gatherv_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Gatherv_init";
+	static constexpr std::string_view mpi_reduce_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Reduce_init";
+	static constexpr std::string_view mpi_reduce_scatter_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Reduce_scatter_init";
+	static constexpr std::string_view mpi_reduce_scatter_block_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Reduce_scatter_block_init";
+	static constexpr std::string_view mpi_scan_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Scan_init";
+	static constexpr std::string_view mpi_scatter_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Scatter_init";
+	static constexpr std::string_view mpi_scatterv_init = MPI_PERSISTENT_COLLECTIVES_C_PREFIX "Scatterv_init";
+
 	//! Other operations
 	static constexpr std::string_view mpi_comm_rank = "MPI_Comm_rank";
 	static constexpr std::string_view mpi_comm_size = "MPI_Comm_size";
 	static constexpr std::string_view mpi_query_thread = "MPI_Query_thread";
+	static constexpr std::string_view mpi_type_size = "MPI_Type_size";
 };
 
 template <>
@@ -230,6 +332,18 @@ struct Names<Fortran> {
 	static constexpr std::string_view mpi_issend = "mpi_issend_";
 	static constexpr std::string_view mpi_isend = "mpi_isend_";
 
+	//! Point-to-point persistent operations
+	static constexpr std::string_view mpi_recv_init = "mpi_recv_init_";
+	static constexpr std::string_view mpi_send_init = "mpi_send_init_";
+	static constexpr std::string_view mpi_start = "mpi_start_";
+	static constexpr std::string_view mpi_request_free = "mpi_request_free_";
+
+	//! Point-to-point partitioned operations
+	static constexpr std::string_view mpi_precv_init = "mpi_precv_init_";
+	static constexpr std::string_view mpi_psend_init = "mpi_psend_init_";
+	static constexpr std::string_view mpi_pready = "mpi_pready_";
+	static constexpr std::string_view mpi_parrived = "mpi_parrived_";
+
 	//! Collective non-blocking operations
 	static constexpr std::string_view mpi_iallgather = "mpi_iallgather_";
 	static constexpr std::string_view mpi_iallgatherv = "mpi_iallgatherv_";
@@ -249,10 +363,31 @@ struct Names<Fortran> {
 	static constexpr std::string_view mpi_iscan = "mpi_iscan_";
 	static constexpr std::string_view mpi_iexscan = "mpi_iexscan_";
 
+	//! Collective persistent operations. There are no Fortran entry points
+	//! for them, so only the standard names are declared
+	static constexpr std::string_view mpi_allgather_init = "mpi_allgather_init_";
+	static constexpr std::string_view mpi_allgatherv_init = "mpi_allgatherv_init_";
+	static constexpr std::string_view mpi_allreduce_init = "mpi_allreduce_init_";
+	static constexpr std::string_view mpi_alltoall_init = "mpi_alltoall_init_";
+	static constexpr std::string_view mpi_alltoallv_init = "mpi_alltoallv_init_";
+	static constexpr std::string_view mpi_alltoallw_init = "mpi_alltoallw_init_";
+	static constexpr std::string_view mpi_barrier_init = "mpi_barrier_init_";
+	static constexpr std::string_view mpi_bcast_init = "mpi_bcast_init_";
+	static constexpr std::string_view mpi_exscan_init = "mpi_exscan_init_";
+	static constexpr std::string_view mpi_gather_init = "mpi_gather_init_";
+	static constexpr std::string_view mpi_gatherv_init = "mpi_gatherv_init_";
+	static constexpr std::string_view mpi_reduce_init = "mpi_reduce_init_";
+	static constexpr std::string_view mpi_reduce_scatter_init = "mpi_reduce_scatter_init_";
+	static constexpr std::string_view mpi_reduce_scatter_block_init = "mpi_reduce_scatter_block_init_";
+	static constexpr std::string_view mpi_scan_init = "mpi_scan_init_";
+	static constexpr std::string_view mpi_scatter_init = "mpi_scatter_init_";
+	static constexpr std::string_view mpi_scatterv_init = "mpi_scatterv_init_";
+
 	//! Other operations
 	static constexpr std::string_view mpi_comm_rank = "mpi_comm_rank_";
 	static constexpr std::string_view mpi_comm_size = "mpi_comm_size_";
 	static constexpr std::string_view mpi_query_thread = "mpi_query_thread_";
+	static constexpr std::string_view mpi_type_size = "mpi_type_size_";
 };
 
 } // namespace tampi
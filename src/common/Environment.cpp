@@ -1,12 +1,13 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2025 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #include <cstdio>
 
 #include "Environment.hpp"
+#include "PersistentRequests.hpp"
 #include "polling/Polling.hpp"
 #include "util/ErrorHandler.hpp"
 
@@ -16,14 +17,27 @@ namespace tampi {
 Environment::State Environment::_state;
 thread_local bool Environment::State::threadTaskAwareness = true;
 
-TaskingModel::PollingInstance *Polling::_pollingInstance;
+std::vector<TaskingModel::PollingInstance *> Polling::_pollingInstances;
+std::vector<PollingPeriodCtrl *> Polling::_periodCtrls;
 TaskingModel::PollingInstance *Polling::_completionPollingInstance;
-PollingPeriodCtrl Polling::_periodCtrl("TAMPI_POLLING_PERIOD");
 PollingPeriodCtrl Polling::_completionPeriodCtrl("TAMPI_POLLING_TASK_COMPLETION_PERIOD");
 EnvironmentVariable<std::string> TaskingModel::_pollingMode("TAMPI_POLLING_MODE", "auto");
+EnvironmentVariable<bool> TaskingModel::_idleParkingEnabled("TAMPI_POLLING_IDLE_PARKING", true);
 
 EnvironmentVariable<bool> CompletionManager::_enabled("TAMPI_POLLING_TASK_COMPLETION", true);
-CompletionManager::queue_t CompletionManager::_queue;
+TaskingModel::PollingInstance *CompletionManager::_pollingInstance = nullptr;
+CompletionManager::queue_t *CompletionManager::_queues = nullptr;
+size_t CompletionManager::_nqueues = 0;
+std::vector<TaskContext> *CompletionManager::_overflows = nullptr;
+
+EnvironmentVariable<size_t> Sharding::_nshards("TAMPI_SHARDS", 1);
+
+PersistentRequests::Stripe PersistentRequests::_stripes[PersistentRequests::NumStripes];
+
+EnvironmentVariable<bool> Backpressure::_enabled("TAMPI_BACKPRESSURE", false);
+
+Memory::HugePagesPolicy Memory::_hugePages = Memory::NoHugePages;
+bool Memory::_numaBinding = false;
 
 std::mutex ErrorHandler::_lock;
 
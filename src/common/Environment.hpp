@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef ENVIRONMENT_HPP
@@ -17,11 +17,14 @@
 
 #include "Allocator.hpp"
 #include "Interface.hpp"
+#include "Sharding.hpp"
 #include "TaskContext.hpp"
 #include "TaskingModel.hpp"
 #include "TicketManager.hpp"
 #include "instrument/Instrument.hpp"
 #include "polling/Polling.hpp"
+#include "util/Clock.hpp"
+#include "util/EnvironmentVariable.hpp"
 #include "util/ErrorHandler.hpp"
 
 
@@ -50,6 +53,9 @@ private:
 		//! is enabled
 		static thread_local bool threadTaskAwareness;
 
+		//! Indicate whether the statistics are reported
+		bool stats;
+
 		//! Indicate whether the blocking and non-blocking modes are enabled
 		std::atomic<bool> blockingMode;
 		std::atomic<bool> nonBlockingMode;
@@ -63,6 +69,7 @@ private:
 			initialized(false),
 			autoInitialize(true),
 			nativeThreadLevel(MPI_THREAD_SINGLE),
+			stats(false),
 			blockingMode(false),
 			nonBlockingMode(false),
 			mutex()
@@ -226,16 +233,38 @@ public:
 		int rank = InterfaceAny::rank;
 		int nranks = InterfaceAny::nranks;
 
+		_state.stats = EnvironmentVariable<bool>("TAMPI_STATS", false);
+
+		// The timestamps (in ns) of the initialization steps
+		uint64_t times[5];
+		times[0] = Clock::now_ns();
+
 		// Find the tasking runtime symbols
 		TaskingModel::initialize(enableBlocking, enableNonBlocking);
+		times[1] = Clock::now_ns();
 
 		// Initialize the instrumentation
 		Instrument::initialize(rank, nranks);
+		times[2] = Clock::now_ns();
 
-		// Initialize allocators and launch a polling task if required
+		// Initialize allocators and launch a polling task if required. The
+		// allocators and the queues start empty and grow on first use
 		if (enableBlocking || enableNonBlocking) {
+			Memory::initialize();
+			Sharding::initialize();
 			Allocator::initialize();
+			times[3] = Clock::now_ns();
+
 			Polling::initialize();
+			times[4] = Clock::now_ns();
+		} else {
+			times[3] = times[4] = times[2];
+		}
+
+		if (_state.stats) {
+			ErrorHandler::info("Startup in rank ", rank, ": total=", (times[4] - times[0]) / 1000,
+				"us tasking=", (times[1] - times[0]) / 1000, "us instrument=", (times[2] - times[1]) / 1000,
+				"us allocators=", (times[3] - times[2]) / 1000, "us polling=", (times[4] - times[3]) / 1000, "us");
 		}
 
 		// Mark the library as initialized
@@ -268,6 +297,9 @@ public:
 		// Finalize the polling task and the allocators
 		if (_state.blockingMode || _state.nonBlockingMode) {
 			Polling::finalize();
+
+			if (_state.stats)
+				Allocator::reportStats();
 			Allocator::finalize();
 		}
 
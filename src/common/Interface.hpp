@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2022-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2022-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef INTERFACE_HPP
@@ -50,6 +50,7 @@ class Interface {
 	typedef typename Types<Lang>::request_t request_t;
 	typedef typename Types<Lang>::status_t status_t;
 	typedef typename Types<Lang>::status_ptr_t status_ptr_t;
+	typedef typename Types<Lang>::datatype_t datatype_t;
 
 public:
 	static Symbol<typename Prototypes<Lang>::mpi_test_t> mpi_test;
@@ -58,6 +59,7 @@ public:
 	static Symbol<typename Prototypes<Lang>::mpi_testsome_t> mpi_testsome;
 	static Symbol<typename Prototypes<Lang>::mpi_comm_rank_t> mpi_comm_rank;
 	static Symbol<typename Prototypes<Lang>::mpi_comm_size_t> mpi_comm_size;
+	static Symbol<typename Prototypes<Lang>::mpi_type_size_t> mpi_type_size;
 
 	static Symbol<typename Prototypes<Lang>::mpi_ibsend_t> mpi_ibsend;
 	static Symbol<typename Prototypes<Lang>::mpi_irecv_t> mpi_irecv;
@@ -65,6 +67,16 @@ public:
 	static Symbol<typename Prototypes<Lang>::mpi_isend_t> mpi_isend;
 	static Symbol<typename Prototypes<Lang>::mpi_issend_t> mpi_issend;
 
+	static Symbol<typename Prototypes<Lang>::mpi_recv_init_t> mpi_recv_init;
+	static Symbol<typename Prototypes<Lang>::mpi_send_init_t> mpi_send_init;
+	static Symbol<typename Prototypes<Lang>::mpi_start_t> mpi_start;
+	static Symbol<typename Prototypes<Lang>::mpi_request_free_t> mpi_request_free;
+
+	static Symbol<typename Prototypes<Lang>::mpi_precv_init_t> mpi_precv_init;
+	static Symbol<typename Prototypes<Lang>::mpi_psend_init_t> mpi_psend_init;
+	static Symbol<typename Prototypes<Lang>::mpi_pready_t> mpi_pready;
+	static Symbol<typename Prototypes<Lang>::mpi_parrived_t> mpi_parrived;
+
 	static Symbol<typename Prototypes<Lang>::mpi_iallgather_t> mpi_iallgather;
 	static Symbol<typename Prototypes<Lang>::mpi_iallgatherv_t> mpi_iallgatherv;
 	static Symbol<typename Prototypes<Lang>::mpi_iallreduce_t> mpi_iallreduce;
@@ -83,6 +95,24 @@ public:
 	static Symbol<typename Prototypes<Lang>::mpi_iscan_t> mpi_iscan;
 	static Symbol<typename Prototypes<Lang>::mpi_iexscan_t> mpi_iexscan;
 
+	static Symbol<typename Prototypes<Lang>::mpi_allgather_init_t> mpi_allgather_init;
+	static Symbol<typename Prototypes<Lang>::mpi_allgatherv_init_t> mpi_allgatherv_init;
+	static Symbol<typename Prototypes<Lang>::mpi_allreduce_init_t> mpi_allreduce_init;
+	static Symbol<typename Prototypes<Lang>::mpi_alltoall_init_t> mpi_alltoall_init;
+	static Symbol<typename Prototypes<Lang>::mpi_alltoallv_init_t> mpi_alltoallv_init;
+	static Symbol<typename Prototypes<Lang>::mpi_alltoallw_init_t> mpi_alltoallw_init;
+	static Symbol<typename Prototypes<Lang>::mpi_barrier_init_t> mpi_barrier_init;
+	static Symbol<typename Prototypes<Lang>::mpi_bcast_init_t> mpi_bcast_init;
+	static Symbol<typename Prototypes<Lang>::mpi_exscan_init_t> mpi_exscan_init;
+	static Symbol<typename Prototypes<Lang>::mpi_gather_init_t> mpi_gather_init;
+	static Symbol<typename Prototypes<Lang>::mpi_gatherv_init_t> mpi_gatherv_init;
+	static Symbol<typename Prototypes<Lang>::mpi_reduce_init_t> mpi_reduce_init;
+	static Symbol<typename Prototypes<Lang>::mpi_reduce_scatter_init_t> mpi_reduce_scatter_init;
+	static Symbol<typename Prototypes<Lang>::mpi_reduce_scatter_block_init_t> mpi_reduce_scatter_block_init;
+	static Symbol<typename Prototypes<Lang>::mpi_scan_init_t> mpi_scan_init;
+	static Symbol<typename Prototypes<Lang>::mpi_scatter_init_t> mpi_scatter_init;
+	static Symbol<typename Prototypes<Lang>::mpi_scatterv_init_t> mpi_scatterv_init;
+
 	static request_t REQUEST_NULL;
 	static status_ptr_t STATUS_IGNORE;
 	static status_ptr_t STATUSES_IGNORE;
@@ -96,6 +126,10 @@ public:
 	static bool testall(int size, request_t *requests, status_ptr_t statuses);
 	static bool testany(int size, request_t *requests, int *index, status_ptr_t status);
 	static int testsome(int size, request_t *requests, int *indices, status_ptr_t statuses);
+	static bool parrived(request_t request, int partition);
+	static void start(request_t &request);
+	static void requestFree(request_t &request);
+	static size_t typeSize(datatype_t datatype);
 };
 
 template <>
@@ -135,6 +169,7 @@ inline void Interface<Lang>::loadSymbols()
 	mpi_testsome.load(SymbolAttr::Next, true);
 	mpi_comm_rank.load(SymbolAttr::Next, true);
 	mpi_comm_size.load(SymbolAttr::Next, true);
+	mpi_type_size.load(SymbolAttr::Next, true);
 
 	mpi_ibsend.load(SymbolAttr::Next, true);
 	mpi_irecv.load(SymbolAttr::Next, true);
@@ -142,6 +177,17 @@ inline void Interface<Lang>::loadSymbols()
 	mpi_isend.load(SymbolAttr::Next, true);
 	mpi_issend.load(SymbolAttr::Next, true);
 
+	mpi_recv_init.load(SymbolAttr::Next, true);
+	mpi_send_init.load(SymbolAttr::Next, true);
+	mpi_start.load(SymbolAttr::Next, true);
+	mpi_request_free.load(SymbolAttr::Next, true);
+
+	// The partitioned operations are optional
+	mpi_precv_init.load(SymbolAttr::Next, false);
+	mpi_psend_init.load(SymbolAttr::Next, false);
+	mpi_pready.load(SymbolAttr::Next, false);
+	mpi_parrived.load(SymbolAttr::Next, false);
+
 	mpi_iallgather.load(SymbolAttr::Next, true);
 	mpi_iallgatherv.load(SymbolAttr::Next, true);
 	mpi_iallreduce.load(SymbolAttr::Next, true);
@@ -159,6 +205,25 @@ inline void Interface<Lang>::loadSymbols()
 	mpi_iscatterv.load(SymbolAttr::Next, true);
 	mpi_iscan.load(SymbolAttr::Next, true);
 	mpi_iexscan.load(SymbolAttr::Next, true);
+
+	// The persistent collectives are optional
+	mpi_allgather_init.load(SymbolAttr::Next, false);
+	mpi_allgatherv_init.load(SymbolAttr::Next, false);
+	mpi_allreduce_init.load(SymbolAttr::Next, false);
+	mpi_alltoall_init.load(SymbolAttr::Next, false);
+	mpi_alltoallv_init.load(SymbolAttr::Next, false);
+	mpi_alltoallw_init.load(SymbolAttr::Next, false);
+	mpi_barrier_init.load(SymbolAttr::Next, false);
+	mpi_bcast_init.load(SymbolAttr::Next, false);
+	mpi_exscan_init.load(SymbolAttr::Next, false);
+	mpi_gather_init.load(SymbolAttr::Next, false);
+	mpi_gatherv_init.load(SymbolAttr::Next, false);
+	mpi_reduce_init.load(SymbolAttr::Next, false);
+	mpi_reduce_scatter_init.load(SymbolAttr::Next, false);
+	mpi_reduce_scatter_block_init.load(SymbolAttr::Next, false);
+	mpi_scan_init.load(SymbolAttr::Next, false);
+	mpi_scatter_init.load(SymbolAttr::Next, false);
+	mpi_scatterv_init.load(SymbolAttr::Next, false);
 }
 
 template <>
@@ -215,6 +280,44 @@ inline int Interface<C>::testsome(int size, request_t *requests, int *indices, s
 	return completed;
 }
 
+template <>
+inline bool Interface<C>::parrived(request_t request, int partition)
+{
+	int arrived;
+	int err = mpi_parrived(request, partition, &arrived);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Parrived");
+
+	return arrived;
+}
+
+template <>
+inline void Interface<C>::start(request_t &request)
+{
+	int err = mpi_start(&request);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Start");
+}
+
+template <>
+inline void Interface<C>::requestFree(request_t &request)
+{
+	int err = mpi_request_free(&request);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Request_free");
+}
+
+template <>
+inline size_t Interface<C>::typeSize(datatype_t datatype)
+{
+	int size;
+	int err = mpi_type_size(datatype, &size);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Type_size");
+
+	return size;
+}
+
 template <>
 inline bool Interface<Fortran>::test(request_t &request, status_ptr_t status)
 {
@@ -276,6 +379,47 @@ inline int Interface<Fortran>::testsome(int size, request_t *requests, int *indi
 	return completed;
 }
 
+template <>
+inline bool Interface<Fortran>::parrived(request_t request, int partition)
+{
+	MPI_Fint fpartition = partition;
+	MPI_Fint arrived, err;
+	mpi_parrived(&request, &fpartition, &arrived, &err);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Parrived");
+
+	return arrived;
+}
+
+template <>
+inline void Interface<Fortran>::start(request_t &request)
+{
+	MPI_Fint err;
+	mpi_start(&request, &err);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Start");
+}
+
+template <>
+inline void Interface<Fortran>::requestFree(request_t &request)
+{
+	MPI_Fint err;
+	mpi_request_free(&request, &err);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Request_free");
+}
+
+template <>
+inline size_t Interface<Fortran>::typeSize(datatype_t datatype)
+{
+	MPI_Fint size, err;
+	mpi_type_size(datatype, &size, &err);
+	if (err != MPI_SUCCESS)
+		ErrorHandler::fail("Unexpected return code from MPI_Type_size");
+
+	return size;
+}
+
 template <typename Lang>
 typename Types<Lang>::request_t Interface<Lang>::REQUEST_NULL;
 template <typename Lang>
@@ -300,6 +444,8 @@ template <typename Lang>
 Symbol<typename Prototypes<Lang>::mpi_comm_rank_t> Interface<Lang>::mpi_comm_rank(Names<Lang>::mpi_comm_rank, false);
 template <typename Lang>
 Symbol<typename Prototypes<Lang>::mpi_comm_size_t> Interface<Lang>::mpi_comm_size(Names<Lang>::mpi_comm_size, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_type_size_t> Interface<Lang>::mpi_type_size(Names<Lang>::mpi_type_size, false);
 
 template <typename Lang>
 Symbol<typename Prototypes<Lang>::mpi_ibsend_t> Interface<Lang>::mpi_ibsend(Names<Lang>::mpi_ibsend, false);
@@ -312,6 +458,24 @@ Symbol<typename Prototypes<Lang>::mpi_isend_t> Interface<Lang>::mpi_isend(Names<
 template <typename Lang>
 Symbol<typename Prototypes<Lang>::mpi_issend_t> Interface<Lang>::mpi_issend(Names<Lang>::mpi_issend, false);
 
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_recv_init_t> Interface<Lang>::mpi_recv_init(Names<Lang>::mpi_recv_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_send_init_t> Interface<Lang>::mpi_send_init(Names<Lang>::mpi_send_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_start_t> Interface<Lang>::mpi_start(Names<Lang>::mpi_start, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_request_free_t> Interface<Lang>::mpi_request_free(Names<Lang>::mpi_request_free, false);
+
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_precv_init_t> Interface<Lang>::mpi_precv_init(Names<Lang>::mpi_precv_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_psend_init_t> Interface<Lang>::mpi_psend_init(Names<Lang>::mpi_psend_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_pready_t> Interface<Lang>::mpi_pready(Names<Lang>::mpi_pready, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_parrived_t> Interface<Lang>::mpi_parrived(Names<Lang>::mpi_parrived, false);
+
 template <typename Lang>
 Symbol<typename Prototypes<Lang>::mpi_iallgather_t> Interface<Lang>::mpi_iallgather(Names<Lang>::mpi_iallgather, false);
 template <typename Lang>
@@ -347,6 +511,41 @@ Symbol<typename Prototypes<Lang>::mpi_iscan_t> Interface<Lang>::mpi_iscan(Names<
 template <typename Lang>
 Symbol<typename Prototypes<Lang>::mpi_iexscan_t> Interface<Lang>::mpi_iexscan(Names<Lang>::mpi_iexscan, false);
 
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_allgather_init_t> Interface<Lang>::mpi_allgather_init(Names<Lang>::mpi_allgather_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_allgatherv_init_t> Interface<Lang>::mpi_allgatherv_init(Names<Lang>::mpi_allgatherv_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_allreduce_init_t> Interface<Lang>::mpi_allreduce_init(Names<Lang>::mpi_allreduce_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_alltoall_init_t> Interface<Lang>::mpi_alltoall_init(Names<Lang>::mpi_alltoall_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_alltoallv_init_t> Interface<Lang>::mpi_alltoallv_init(Names<Lang>::mpi_alltoallv_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_alltoallw_init_t> Interface<Lang>::mpi_alltoallw_init(Names<Lang>::mpi_alltoallw_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_barrier_init_t> Interface<Lang>::mpi_barrier_init(Names<Lang>::mpi_barrier_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_bcast_init_t> Interface<Lang>::mpi_bcast_init(Names<Lang>::mpi_bcast_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_exscan_init_t> Interface<Lang>::mpi_exscan_init(Names<Lang>::mpi_exscan_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_gather_init_t> Interface<Lang>::mpi_gather_init(Names<Lang>::mpi_gather_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_gatherv_init_t> Interface<Lang>::mpi_gatherv_init(Names<Lang>::mpi_gatherv_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_reduce_init_t> Interface<Lang>::mpi_reduce_init(Names<Lang>::mpi_reduce_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_reduce_scatter_init_t> Interface<Lang>::mpi_reduce_scatter_init(Names<Lang>::mpi_reduce_scatter_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_reduce_scatter_block_init_t> Interface<Lang>::mpi_reduce_scatter_block_init(Names<Lang>::mpi_reduce_scatter_block_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_scan_init_t> Interface<Lang>::mpi_scan_init(Names<Lang>::mpi_scan_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_scatter_init_t> Interface<Lang>::mpi_scatter_init(Names<Lang>::mpi_scatter_init, false);
+template <typename Lang>
+Symbol<typename Prototypes<Lang>::mpi_scatterv_init_t> Interface<Lang>::mpi_scatterv_init(Names<Lang>::mpi_scatterv_init, false);
+
 #if !defined(DISABLE_C_LANG)
 using InterfaceAny = Interface<C>;
 #elif !defined(DISABLE_FORTRAN_LANG)
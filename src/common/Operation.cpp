@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #include "Interface.hpp"
@@ -31,6 +31,11 @@ Operation<C>::request_t Operation<C>::issue()
 		case RECV:
 			err = Interface<C>::mpi_irecv(_buffer, _count, _datatype, _rank, _tag, _comm, &request);
 			break;
+		case START:
+		case STARTSEND:
+			request = _request;
+			err = Interface<C>::mpi_start(&request);
+			break;
 		default:
 			ErrorHandler::fail("Invalid operation ", _code);
 			break;
@@ -100,6 +105,10 @@ Operation<C>::request_t CollOperation<C>::issue()
 		case SCATTERV:
 			err = Interface<C>::mpi_iscatterv(_sendbuf, _sendcounts, _senddispls, _sendtype, _recvbuf, _recvcount, _recvtype, _rank, _comm, &request);
 			break;
+		case START:
+			request = _request;
+			err = Interface<C>::mpi_start(&request);
+			break;
 		default:
 			ErrorHandler::fail("Invalid large operation ", _code);
 			break;
@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef OPERATION_HPP
@@ -25,6 +25,8 @@ enum OpCode : char {
 	RSEND,
 	SEND,
 	SSEND,
+	START,
+	STARTSEND,
 	// Collective operations
 	ALLGATHER,
 	ALLGATHERV,
@@ -60,7 +62,10 @@ struct Operation {
 
 	TaskingModel::task_handle_t _task;
 	status_ptr_t _status;
-	void *_buffer;
+	union {
+		void *_buffer;
+		request_t _request;
+	};
 	int_t _count;
 	datatype_t _datatype;
 	comm_t _comm;
@@ -79,6 +84,26 @@ struct Operation {
 	{
 	}
 
+	//! Construct the start of a persistent request
+	Operation(TaskingModel::task_handle_t task, OpNature nature,
+		request_t request, comm_t comm, status_ptr_t status
+	) :
+		_task(task), _status(status), _request(request), _count(0), _datatype(),
+		_comm(comm), _rank(0), _tag(0), _code(START), _nature(nature)
+	{
+	}
+
+	//! Construct the start of a persistent send request. The destination and
+	//! the size of the message are kept for the flow control
+	Operation(TaskingModel::task_handle_t task, OpNature nature,
+		request_t request, int_t count, datatype_t datatype, int_t rank,
+		comm_t comm, status_ptr_t status
+	) :
+		_task(task), _status(status), _request(request), _count(count), _datatype(datatype),
+		_comm(comm), _rank(rank), _tag(0), _code(STARTSEND), _nature(nature)
+	{
+	}
+
 	Operation() : _code(NONE)
 	{
 	}
@@ -105,7 +130,10 @@ struct CollOperation {
 	typedef typename Types<Lang>::request_t request_t;
 
 	TaskingModel::task_handle_t _task;
-	const void *_sendbuf;
+	union {
+		const void *_sendbuf;
+		request_t _request;
+	};
 	void *_recvbuf;
 	const int_t *_senddispls;
 	const int_t *_recvdispls;
@@ -193,6 +221,17 @@ struct CollOperation {
 	{
 	}
 
+	//! Construct the start of a persistent collective request
+	CollOperation(TaskingModel::task_handle_t task, OpCode code, OpNature nature,
+		comm_t comm, request_t request
+	) :
+		_task(task), _request(request), _recvbuf(nullptr), _senddispls(nullptr),
+		_recvdispls(nullptr), _sendcount(0), _recvcount(0), _sendtype(), _recvtype(),
+		_comm(comm), _rank(0), _op(), _code(code), _nature(nature)
+	{
+		assert(code == START);
+	}
+
 	CollOperation() : _code(NONE)
 	{
 	}
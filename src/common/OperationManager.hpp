@@ -1,14 +1,16 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef OPERATION_MANAGER_HPP
 #define OPERATION_MANAGER_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <mpi.h>
+#include <type_traits>
 
 #include "Allocator.hpp"
 #include "Operation.hpp"
@@ -55,16 +57,31 @@ public:
 
 		// Construct a task context
 		TaskContext taskContext(nature == BLK);
+
+		// Try to issue small point-to-point operations directly
+		if constexpr (std::is_same_v<Op<Lang>, Operation<Lang>>) {
+			if (processDirectly(taskContext, code, nature, args...))
+				return;
+		}
+
 		taskContext.bindEvents(1);
 
-		// Allocate and construct the operation
-		Op<Lang> *operation = Allocator::alloc<Op<Lang>>(
-				taskContext.getTaskHandle(), code, nature,
-				std::forward<Args>(args)...);
+		// Delegate the processing of the operation. The point-to-point
+		// operations are copied into the queues, while the collective ones
+		// are allocated and passed by pointer
+		if constexpr (std::is_same_v<Op<Lang>, Operation<Lang>>) {
+			Op<Lang> operation(taskContext.getTaskHandle(), code, nature, std::forward<Args>(args)...);
 
-		// Delegate the processing of the operation
-		TicketManager &manager = TicketManager::get();
-		manager.addOperation(operation);
+			TicketManager &manager = TicketManager::getByComm(operation.getComm());
+			manager.addOperation(operation);
+		} else {
+			Op<Lang> *operation = Allocator::alloc<Op<Lang>>(
+					taskContext.getTaskHandle(), code, nature,
+					std::forward<Args>(args)...);
+
+			TicketManager &manager = TicketManager::getByComm(operation->getComm());
+			manager.addOperation(operation);
+		}
 
 		// Wait the operation if it is blocking
 		if (taskContext.isBlocking()) {
@@ -72,6 +89,94 @@ public:
 			taskContext.waitEventsCompletion();
 		}
 	}
+
+	//! \brief Process a batch of non-blocking point-to-point operations
+	//!
+	//! The events of the calling task are increased once for the whole batch
+	//! and the operations are constructed in the stack and pushed into the
+	//! pre-queues in chunks. Consecutive operations on the same shard share
+	//! the chunk. The events are fulfilled as the operations complete, so the
+	//! task dependencies are released once all of them have finished
+	//!
+	//! \param count The number of operations
+	//! \param builder The function constructing an operation given the task
+	//!                handle and the index of the operation in the batch
+	template <typename Builder>
+	static void processBatch(int count, Builder &&builder)
+	{
+		static_assert(std::is_same_v<Op<Lang>, Operation<Lang>>);
+
+		Instrument::Guard<LibraryInterface> instrGuard;
+
+		if (count <= 0)
+			return;
+
+		// Construct a task context and bind all the events at once
+		TaskContext taskContext(false);
+		taskContext.bindEvents(count);
+
+		Op<Lang> operations[BatchChunkSize];
+		TicketManager *manager = nullptr;
+		int n = 0;
+
+		for (int o = 0; o < count; ++o) {
+			Op<Lang> operation = builder(taskContext.getTaskHandle(), o);
+
+			// Push the pending chunk if full or on another shard
+			TicketManager &target = TicketManager::getByComm(operation.getComm());
+			if (n == BatchChunkSize || (n > 0 && &target != manager)) {
+				manager->addOperations(operations, n);
+				n = 0;
+			}
+			manager = &target;
+			operations[n++] = operation;
+		}
+
+		assert(manager != nullptr);
+		manager->addOperations(operations, n);
+	}
+
+private:
+	//! The number of operations of a batch pushed at once
+	static constexpr int BatchChunkSize = 64;
+
+	//! \brief Try to issue an operation directly from the calling task
+	//!
+	//! The operation is constructed in the stack and the ticket manager tries
+	//! to issue it without passing through the pre-queues. If the operation
+	//! completes immediately, there is nothing else to do. If it is pending,
+	//! the ticket manager has already bound the task events and the operation
+	//! is waited if it is blocking
+	//!
+	//! \param taskContext The context of the calling task
+	//! \param code The code of the operation: send, recv, etc
+	//! \param nature The nature of the operation: blocking or non-blocking
+	//! \param args The rest of arguments to construct the operation
+	//!
+	//! \returns Whether the operation was issued directly
+	template <typename... Args>
+	static bool processDirectly(TaskContext &taskContext, OpCode code, OpNature nature, Args &&... args)
+	{
+		typedef typename TicketManager::DirectIssueResult DirectIssueResult;
+
+		// All ticket managers share the same configuration
+		if (!TicketManager::get().isDirectIssueEnabled())
+			return false;
+
+		Op<Lang> operation(taskContext.getTaskHandle(), code, nature, std::forward<Args>(args)...);
+
+		TicketManager &manager = TicketManager::getByComm(operation.getComm());
+		DirectIssueResult result = manager.directIssue(operation);
+		if (result == DirectIssueResult::NotIssued)
+			return false;
+
+		// Wait the operation if it is blocking and still pending
+		if (result == DirectIssueResult::Pending && taskContext.isBlocking()) {
+			Instrument::Guard<WaitTicket> instrGuard;
+			taskContext.waitEventsCompletion();
+		}
+		return true;
+	}
 };
 
 } // namespace tampi
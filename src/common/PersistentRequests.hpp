@@ -0,0 +1,182 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef PERSISTENT_REQUESTS_HPP
+#define PERSISTENT_REQUESTS_HPP
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "Sharding.hpp"
+#include "util/ErrorHandler.hpp"
+#include "util/Utils.hpp"
+
+namespace tampi {
+
+//! Class that records the persistent requests created through TAMPI. MPI does
+//! not provide the communicator nor the kind of a request, but the starts of a
+//! persistent request must be routed to the shard of its communicator and, if
+//! it is collective, through the ordered collective queues to keep the MPI
+//! ordering with the rest of operations. The partitioned requests are started
+//! directly and tracked by the ticket manager of their shard. The requests are
+//! distributed among several independent maps, so the concurrent starts rarely
+//! contend on the same lock, and they are forgotten when freed through TAMPI
+class PersistentRequests {
+public:
+	//! The kinds of persistent requests
+	enum Kind {
+		PointToPoint = 0,
+		Send,
+		Collective,
+		Partitioned
+	};
+
+	//! The information of a persistent request
+	struct Info {
+		//! The communicator of the request
+		MPI_Comm comm;
+
+		//! The kind of the request
+		Kind kind;
+
+		//! The destination, count and datatype of a send request
+		int rank;
+		int count;
+		MPI_Datatype datatype;
+	};
+
+private:
+	//! The number of maps; must be a power of two
+	static constexpr size_t NumStripes = 64;
+
+	//! A map of persistent requests with its own lock
+	struct alignas(CacheAlignment) Stripe {
+		//! The information of the persistent requests
+		std::unordered_map<MPI_Request, Info> requests;
+
+		//! The mutex protecting the map
+		std::mutex mutex;
+	};
+
+	//! The maps of persistent requests
+	static Stripe _stripes[NumStripes];
+
+	//! \brief Get the map of a persistent request
+	//!
+	//! The hash is mixed since the request handles are usually aligned
+	//! pointers or consecutive integers
+	static Stripe &getStripe(MPI_Request request)
+	{
+		static_assert((NumStripes & (NumStripes - 1)) == 0);
+
+		uint64_t hash = std::hash<MPI_Request>()(request);
+		hash *= 0x9E3779B97F4A7C15ULL;
+		return _stripes[(hash >> 32) & (NumStripes - 1)];
+	}
+
+public:
+	PersistentRequests() = delete;
+	PersistentRequests(const PersistentRequests &) = delete;
+	const PersistentRequests& operator= (const PersistentRequests &) = delete;
+
+	//! \brief Record a persistent request
+	//!
+	//! A request handle freed by MPI and reused later is overwritten
+	//!
+	//! \param request The persistent request
+	//! \param comm The communicator of the request
+	//! \param kind The kind of the request
+	//! \param rank The destination of a send request
+	//! \param count The number of elements of a send request
+	//! \param datatype The datatype of a send request
+	static void record(MPI_Request request, MPI_Comm comm, Kind kind,
+		int rank = MPI_PROC_NULL, int count = 0, MPI_Datatype datatype = MPI_DATATYPE_NULL)
+	{
+		Stripe &stripe = getStripe(request);
+		std::lock_guard<std::mutex> guard(stripe.mutex);
+		stripe.requests[request] = Info{ comm, kind, rank, count, datatype };
+	}
+
+	//! \brief Forget a persistent request that is going to be freed
+	//!
+	//! \param request The persistent request
+	//! \param info The location where to save the information of the request
+	//!
+	//! \returns Whether the request was created through TAMPI
+	static bool erase(MPI_Request request, Info &info)
+	{
+		Stripe &stripe = getStripe(request);
+		std::lock_guard<std::mutex> guard(stripe.mutex);
+
+		auto it = stripe.requests.find(request);
+		if (it == stripe.requests.end())
+			return false;
+
+		info = it->second;
+		stripe.requests.erase(it);
+		return true;
+	}
+
+	//! \brief Get the information of a persistent request
+	//!
+	//! The requests not created through TAMPI are considered point-to-point
+	//! and are only accepted when there is a single shard
+	//!
+	//! \param request The persistent request
+	//!
+	//! \returns The information of the request
+	static Info get(MPI_Request request)
+	{
+		Stripe &stripe = getStripe(request);
+		{
+			std::lock_guard<std::mutex> guard(stripe.mutex);
+			auto it = stripe.requests.find(request);
+			if (it != stripe.requests.end())
+				return it->second;
+		}
+
+		if (Sharding::getNumShards() > 1)
+			ErrorHandler::fail("Persistent request not created through TAMPI");
+		return Info{ MPI_COMM_NULL, PointToPoint, MPI_PROC_NULL, 0, MPI_DATATYPE_NULL };
+	}
+
+	//! \brief Create a persistent collective request
+	//!
+	//! \param function The MPI function creating the request
+	//! \param comm The communicator of the request
+	//! \param request The location where to save the request
+	//! \param args The arguments of the MPI function
+	//!
+	//! \returns The MPI error code
+	template <typename Function, typename... Args>
+	static int createCollective(Function &function, MPI_Comm comm, MPI_Request *request, Args &&... args)
+	{
+#ifdef HAVE_MPI_PERSISTENT_COLLECTIVES
+		int err = function(std::forward<Args>(args)...);
+		if (err == MPI_SUCCESS)
+			record(*request, comm, Collective);
+		return err;
+#else
+		(void) function;
+		(void) comm;
+		(void) request;
+		((void) args, ...);
+
+		ErrorHandler::fail("The MPI library does not support persistent collectives");
+		return MPI_ERR_UNSUPPORTED_OPERATION;
+#endif
+	}
+};
+
+} // namespace tampi
+
+#endif // PERSISTENT_REQUESTS_HPP
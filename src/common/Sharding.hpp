@@ -0,0 +1,75 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef SHARDING_HPP
+#define SHARDING_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "TaskingModel.hpp"
+#include "util/EnvironmentVariable.hpp"
+#include "util/ErrorHandler.hpp"
+
+
+namespace tampi {
+
+//! Class that decides how the TAMPI operations are distributed among the
+//! shards. Each shard has its own ticket managers and polling task, so the
+//! operations of different shards are issued and tested concurrently. All
+//! operations on the same communicator are routed to the same shard, which
+//! preserves the MPI ordering semantics of point-to-point messages and
+//! collectives
+class Sharding {
+private:
+	//! The number of shards
+	static EnvironmentVariable<size_t> _nshards;
+
+public:
+	Sharding() = delete;
+	Sharding(const Sharding &) = delete;
+	const Sharding& operator= (const Sharding &) = delete;
+
+	//! \brief Check the sharding configuration
+	static void initialize()
+	{
+		if (_nshards == 0)
+			ErrorHandler::fail("TAMPI_SHARDS must be greater than zero");
+
+		if (_nshards > TaskingModel::getNumLogicalCPUs())
+			ErrorHandler::fail("TAMPI_SHARDS cannot be greater than the number of CPUs");
+	}
+
+	//! \brief Get the number of shards
+	static size_t getNumShards()
+	{
+		return _nshards;
+	}
+
+	//! \brief Get the shard that processes the operations of a communicator
+	//!
+	//! \param comm The communicator
+	//!
+	//! \returns The shard index
+	template <typename Comm>
+	static size_t getShard(Comm comm)
+	{
+		if (_nshards == 1)
+			return 0;
+
+		// Mix the bits of the handle since it may be a pointer
+		uint64_t key = (uint64_t) (uintptr_t) comm;
+		key ^= key >> 33;
+		key *= 0xff51afd7ed558ccdULL;
+		key ^= key >> 33;
+
+		return key % _nshards;
+	}
+};
+
+} // namespace tampi
+
+#endif // SHARDING_HPP
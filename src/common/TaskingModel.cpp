@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2025 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #include "Symbol.hpp"
@@ -11,6 +11,9 @@
 namespace tampi {
 
 void (*TaskingModel::pollingFunction)(void *args);
+bool TaskingModel::_idleParking = false;
+bool TaskingModel::_taskBlocking = false;
+bool TaskingModel::_taskWaiting = false;
 
 void TaskingModel::initialize(bool requireTaskBlockingAPI, bool requireTaskEventsAPI)
 {
@@ -21,6 +24,9 @@ void TaskingModel::initialize(bool requireTaskBlockingAPI, bool requireTaskEvent
 	// Find the first occurrence of the desired symbol
 	const SymbolAttr attr = SymbolAttr::First;
 
+	_taskBlocking = requireTaskBlockingAPI;
+	_taskWaiting = true;
+
 	_alpi_error_string.load(attr);
 	_alpi_info_get.load(attr, false); // ALPI 1.2
 	_alpi_feature_check.load(attr, false); // ALPI 1.2
@@ -92,6 +98,9 @@ void TaskingModel::initialize(bool requireTaskBlockingAPI, bool requireTaskEvent
 	}
 
 	pollingFunction = useSuspendPolling? suspendPolling : genericPolling;
+
+	// Parking idle polling tasks requires the suspend and events APIs
+	_idleParking = useSuspendPolling && requireTaskEventsAPI && _idleParkingEnabled;
 }
 
 ALPISymbol<ALPISymbolDecl::alpi_error_string_t>
@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2019-2025 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2019-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef TASKING_MODEL_HPP
@@ -112,6 +112,10 @@ public:
 	typedef struct alpi_task *task_handle_t;
 	typedef uint64_t (*polling_function_t)(void *args);
 
+	//! The period that a polling function returns to indicate that it has no
+	//! work. The polling task may be parked until it is notified
+	static constexpr uint64_t IdlePeriod = UINT64_MAX;
+
 	//! Structure that stores information regarding a polling instance
 	struct PollingInstance {
 		std::string _name;
@@ -120,9 +124,16 @@ public:
 		std::atomic<bool> _mustFinish;
 		std::atomic<bool> _finished;
 
+		//! Whether the polling task is parked until notified
+		std::atomic<bool> _parked;
+
+		//! The handle of the polling task while it is parked
+		task_handle_t _task;
+
 		PollingInstance(const std::string &name, polling_function_t function, void *args) :
 			_name(name), _function(function), _args(args),
-			_mustFinish(false), _finished(false)
+			_mustFinish(false), _finished(false),
+			_parked(false), _task(nullptr)
 		{
 		}
 	};
@@ -155,8 +166,18 @@ private:
 	static ALPISymbol<ALPISymbolDecl::alpi_task_suspend_t> _alpi_task_suspend;
 
 	static EnvironmentVariable<std::string> _pollingMode;
+	static EnvironmentVariable<bool> _idleParkingEnabled;
 	static void (*pollingFunction)(void *args);
 
+	//! Whether idle polling tasks are parked until notified
+	static bool _idleParking;
+
+	//! Whether the task blocking API is available
+	static bool _taskBlocking;
+
+	//! Whether the task timed waiting API is available
+	static bool _taskWaiting;
+
 public:
 	//! \brief Initialize and load the symbols of the tasking model
 	//!
@@ -180,18 +201,88 @@ public:
 		const std::string &name,
 		polling_function_t function,
 		void *args
+	) {
+		PollingInstance *instance = createPolling(name, function, args);
+		startPolling(instance);
+
+		return instance;
+	}
+
+	//! \brief Create a polling instance without starting it
+	//!
+	//! This function is useful to publish the polling instance to the
+	//! entities that may notify it before its polling task starts
+	//!
+	//! \param name The name of the polling instance
+	//! \param function The function to be called periodically
+	//! \param args The arguments of the function
+	//!
+	//! \returns The polling instance
+	static PollingInstance *createPolling(
+		const std::string &name,
+		polling_function_t function,
+		void *args
 	) {
 		PollingInstance *instance = new PollingInstance(name, function, args);
 		assert(instance != nullptr);
 
+		return instance;
+	}
+
+	//! \brief Start a polling instance created by createPolling
+	//!
+	//! \param instance The polling instance
+	static void startPolling(PollingInstance *instance)
+	{
+		assert(instance != nullptr);
+
 		// Spawn a task that will do the periodic polling
 		_alpi_task_spawn(
 			pollingFunction,
 			static_cast<void *>(instance),
 			genericCompleted, static_cast<void *>(instance),
-			name.data(), nullptr);
+			instance->_name.data(), nullptr);
+	}
 
-		return instance;
+	//! \brief Indicate whether idle polling tasks are parked
+	//!
+	//! Polling functions should only return IdlePeriod if this is enabled
+	static bool isIdleParkingEnabled()
+	{
+		return _idleParking;
+	}
+
+	//! \brief Indicate whether tasks can be blocked and unblocked
+	static bool isTaskBlockingAvailable()
+	{
+		return _taskBlocking;
+	}
+
+	//! \brief Indicate whether tasks can wait for a time
+	static bool isTaskWaitingAvailable()
+	{
+		return _taskWaiting;
+	}
+
+	//! \brief Notify a polling instance that there is new work
+	//!
+	//! This function wakes up the polling task if it is parked. It must be
+	//! called after making the new work visible to the polling function
+	//!
+	//! \param instance The polling instance
+	static void notifyPolling(PollingInstance *instance)
+	{
+		if (!_idleParking)
+			return;
+
+		assert(instance != nullptr);
+
+		// Order the publication of the work before checking the parked flag.
+		// This pairs with the fence in parkPolling
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (instance->_parked.load(std::memory_order_relaxed) && instance->_parked.exchange(false))
+			_alpi_task_events_decrease(instance->_task, 1);
 	}
 
 	//! \brief Unregister a polling instance
@@ -207,8 +298,9 @@ public:
 	{
 		assert(instance != nullptr);
 
-		// Notify that the polling should stop
+		// Notify that the polling should stop and wake it up if parked
 		instance->_mustFinish = true;
+		notifyPolling(instance);
 
 		// Wait until the spawned task completes
 		while (!instance->_finished) {
@@ -244,6 +336,16 @@ public:
 		_alpi_task_unblock(task);
 	}
 
+	//! \brief Make the current task wait for a time
+	//!
+	//! The CPU is released to other tasks while waiting
+	//!
+	//! \param timeout_ns The time to wait in nanoseconds
+	static void waitCurrentTask(uint64_t timeout_ns)
+	{
+		_alpi_task_waitfor_ns(timeout_ns, nullptr);
+	}
+
 	//! \brief Increase the events of the current task
 	//!
 	//! \param task The current task's handle
@@ -349,10 +451,54 @@ private:
 		// Call the actual polling function
 		target = instance->_function(instance->_args);
 
+		// Park the polling task if there is no work
+		if (target == IdlePeriod) {
+			target = parkPolling(instance);
+			if (target == IdlePeriod)
+				return;
+		}
+
 		// Suspend the polling task for some microseconds
 		suspendCurrentWithTimeout(target * 1000);
 	}
 
+	//! \brief Park the current polling task until notified
+	//!
+	//! The polling task binds an event to itself, publishes that it is parked
+	//! and calls the polling function again to catch the work added before
+	//! the publication. If there is still no work, the task is suspended until
+	//! the notifier fulfills the event. Otherwise, the task is unparked
+	//!
+	//! \param instance The polling instance
+	//!
+	//! \returns IdlePeriod if the task was suspended or the next period
+	static uint64_t parkPolling(PollingInstance *instance)
+	{
+		task_handle_t task = getCurrentTask();
+		instance->_task = task;
+
+		_alpi_task_events_increase(task, 1);
+		instance->_parked.store(true);
+
+		// Order the parked flag before checking for work. This pairs with
+		// the fence in notifyPolling
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		uint64_t target = instance->_function(instance->_args);
+		if (target == IdlePeriod) {
+			// Resubmit once the event has been fulfilled
+			_alpi_task_suspend_mode_set(task, ALPI_SUSPEND_EVENT_SUBMIT, 0);
+			_alpi_task_suspend(task);
+			return IdlePeriod;
+		}
+
+		// There is work; fulfill the event unless a notifier already did
+		if (instance->_parked.exchange(false))
+			_alpi_task_events_decrease(task, 1);
+
+		return target;
+	}
+
 	//! \brief Function called by a polling task is completed
 	//!
 	//! \param args An opaque pointer to the polling instance
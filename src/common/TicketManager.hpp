@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef TICKET_MANAGER_HPP
@@ -12,19 +12,26 @@
 #include <cstdint>
 #include <algorithm>
 #include <mutex>
+#include <string>
 
 #include "Allocator.hpp"
 #include "CompletionManager.hpp"
 #include "Interface.hpp"
 #include "Operation.hpp"
+#include "Sharding.hpp"
 #include "TaskingModel.hpp"
 #include "Ticket.hpp"
 #include "TicketManagerCapacityCtrl.hpp"
+#include "TicketManagerFlowCtrl.hpp"
+#include "TicketManagerPartitionCtrl.hpp"
 #include "TicketManagerInternals.hpp"
+#include "TicketManagerTestingCtrl.hpp"
+#include "TicketManagerTieringCtrl.hpp"
 #include "instrument/Instrument.hpp"
 #include "util/ArrayView.hpp"
 #include "util/BoostLockFreeQueue.hpp"
 #include "util/MultiLockFreeQueue.hpp"
+#include "util/SequencedMultiLockFreeQueue.hpp"
 #include "util/SpinLock.hpp"
 #include "util/Utils.hpp"
 
@@ -41,9 +48,22 @@ private:
 	//! Maximum number of requests to be inserted at once
 	static constexpr int BatchSize = 64;
 
+public:
+	//! The results of trying to issue an operation directly
+	enum class DirectIssueResult {
+		//! The operation was not issued and must go through the pre-queues
+		NotIssued = 0,
+		//! The operation was issued and completed immediately
+		Completed,
+		//! The operation was issued and its request is in-flight
+		Pending
+	};
+
+private:
 	typedef typename Types<Lang>::request_t request_t;
 	typedef typename Types<Lang>::status_t status_t;
 	typedef typename Types<Lang>::status_ptr_t status_ptr_t;
+	typedef typename Types<Lang>::comm_t comm_t;
 
 	typedef tampi::Ticket<Lang> Ticket;
 
@@ -51,37 +71,80 @@ private:
 	typedef tampi::CollOperation<Lang> CollOperation;
 
 	template <typename T>
-	using P2PMultiQueue = MultiLockFreeQueue<T, MultiQueuePopPolicy::CyclicRoundRobin>;
+	using P2PMultiQueue = MultiLockFreeQueue<T>;
+	template <typename T>
+	using P2PPriorityQueue = BoostLockFreeQueue<T>;
 	template <typename T>
-	using CollQueue = BoostLockFreeQueue<T>;
-
-	//! The approaches for request testing
-	enum class TestingApproach {
-		Test = 0,
-		TestSome,
-		TestAny,
-		None
+	using CollQueue = SequencedMultiLockFreeQueue<T>;
+
+	typedef TicketManagerInternals<Lang> Internals;
+	typedef typename TicketManagerFlowCtrl<Lang>::Flow Flow;
+
+	//! The tiers of in-flight requests
+	enum Tier {
+		Hot = 0,
+		Cold,
+		NumTiers
+	};
+
+	//! Structure holding the in-flight requests of a tier
+	struct RequestTier {
+		//! The arrays storing the tickets, requests and statuses
+		Internals arrays;
+
+		//! Number of in-flight requests in the tier
+		int pending;
+
+		RequestTier() : arrays(), pending(0)
+		{
+		}
 	};
 
-	//! Indicates how the MPI requests should tested in general
-	TestingApproach _generalTesting;
+	//! The controller of how the MPI requests are tested in general and
+	//! immediately after being issued
+	TicketManagerTestingCtrl _testingCtrl;
 
-	//! Indicates whether and how the MPI requests should tested immediately
-	TestingApproach _immediateTesting;
+	//! The shard index of this ticket manager
+	size_t _shard;
+
+	//! The polling instance that checks this ticket manager
+	TaskingModel::PollingInstance *_pollingInstance;
+
+	//! The maximum size (in bytes) of the operations that can be issued
+	//! directly by the calling task. Zero disables the direct issue
+	size_t _directIssueThreshold;
+
+	//! Whether the blocking point-to-point operations are prioritized
+	bool _prioritizeBlocking;
 
 	//! The controller of how many in-flight requests we allow concurrently
 	TicketManagerCapacityCtrl _capacityCtrl;
 
+	//! The controller of how in-flight requests are split into tiers
+	TicketManagerTieringCtrl _tieringCtrl;
+
+	//! The controller of the in-flight sends per destination and bytes
+	TicketManagerFlowCtrl<Lang> _flowCtrl;
+
+	//! The controller of the active partitioned requests
+	TicketManagerPartitionCtrl<Lang> _partitionCtrl;
+
 	//! Number of current in-flight requests
 	int _pending;
 
-	//! General arrays storing the tickets, requests and statuses
-	TicketManagerInternals<Lang, TicketManagerCapacityCtrl::max()> _arrays;
+	//! The tiers of in-flight requests. The cold tier is only used when
+	//! the tiering is enabled
+	RequestTier _tiers[NumTiers];
 
-	//! Pre-queues for point-to-point operations
-	P2PMultiQueue<Operation *> _p2pOperations;
+	//! Pre-queues for point-to-point operations; the operations are stored
+	//! by value in the queue segments
+	P2PMultiQueue<Operation> _p2pOperations;
 
-	//! Pre-queues for collective operations
+	//! Pre-queue for high-priority point-to-point operations; the operations
+	//! are stored by value
+	P2PPriorityQueue<Operation> _p2pPriorityOperations;
+
+	//! Pre-queues for collective operations; they keep the push order
 	CollQueue<CollOperation *> _collOperations;
 
 	//! Spinlock for consuming requests from pre-queues and checking in-flight
@@ -90,25 +153,41 @@ private:
 
 public:
 	TicketManager() :
-		_generalTesting(parseTestingOption("TAMPI_REQUESTS_TESTING", TestingApproach::TestSome)),
-		_immediateTesting(parseTestingOption("TAMPI_REQUESTS_IMMEDIATE_TESTING", _generalTesting)),
-		_capacityCtrl(), _pending(0), _arrays(), _p2pOperations(),
-		_collOperations(), _mutex()
+		_testingCtrl(),
+		_shard(0), _pollingInstance(nullptr),
+		_directIssueThreshold(EnvironmentVariable<size_t>("TAMPI_DIRECT_ISSUE_THRESHOLD", 0)),
+		_prioritizeBlocking(EnvironmentVariable<bool>("TAMPI_PRIORITIZE_BLOCKING", false)),
+		_capacityCtrl(), _tieringCtrl(), _flowCtrl(), _partitionCtrl(),
+		_pending(0), _tiers(),
+		_p2pOperations(parsePopPolicy("TAMPI_QUEUES_POP_POLICY")),
+		_p2pPriorityOperations(), _collOperations(), _mutex()
 	{
-		if (_generalTesting == TestingApproach::None)
-			ErrorHandler::fail("Invalid approach for general request testing");
 	}
 
 	TicketManager(const TicketManager &) = delete;
 	const TicketManager& operator= (const TicketManager &) = delete;
 
-	//! \brief Get the ticket manager for a specific language
+	//! \brief Get the ticket manager of a shard for a specific language
+	//!
+	//! \param shard The shard index
 	//!
 	//! \returns A reference to the ticket manager
-	static TicketManager &get()
+	static TicketManager &get(size_t shard = 0)
 	{
-		static TicketManager _ticketManager;
-		return _ticketManager;
+		static TicketManager *_ticketManagers = createShards();
+
+		assert(shard < Sharding::getNumShards());
+		return _ticketManagers[shard];
+	}
+
+	//! \brief Get the ticket manager processing the operations of a communicator
+	//!
+	//! \param comm The communicator
+	//!
+	//! \returns A reference to the ticket manager
+	static TicketManager &getByComm(comm_t comm)
+	{
+		return get(Sharding::getShard(comm));
 	}
 
 	//! \brief Check the in-flight requests
@@ -135,39 +214,226 @@ public:
 			if (_pending < _capacityCtrl.get())
 				inserted = internalCheckOperationQueues(BatchSize*2);
 
-			if (_pending)
-				completed = internalCheckRequests();
+			if (_tiers[Hot].pending)
+				completed = internalCheckRequests(_tiers[Hot]);
 			totalCompleted += completed;
 		} while (completed > 0 || inserted > 0);
 
+		if (_tieringCtrl.isEnabled())
+			totalCompleted += internalCheckTiers();
+
+		// The active partitioned requests are pending as well
+		totalCompleted += _partitionCtrl.check(pending);
+
 		// Evaluate what should be the current capacity
 		_capacityCtrl.evaluate(_pending, totalCompleted);
 
-		pending += _pending;
+		// The held operations are pending as well
+		pending += _pending + _flowCtrl.getNumHeld();
 
 		return totalCompleted;
 	}
 
 	//! \brief Add an operation to the pre-queues
 	//!
-	//! \param operation The operation to add
-	template <typename T>
-	void addOperation(T *operation)
+	//! The blocking point-to-point operations go to the high-priority queue
+	//! if enabled. To preserve the MPI ordering with the operations previously
+	//! issued by the same task, they are only prioritized when there are no
+	//! queued operations from any CPU nor held sends. The task may have queued
+	//! operations from another CPU before being suspended
+	//!
+	//! \param operation The point-to-point operation to copy into the queues
+	void addOperation(const Operation &operation)
+	{
+		if (_prioritizeBlocking && operation._nature == BLK
+				&& _flowCtrl.getNumHeld() == 0 && _p2pOperations.isEmpty())
+			_p2pPriorityOperations.push(operation);
+		else
+			_p2pOperations.push(operation);
+
+		// Wake up the polling task if it is parked
+		TaskingModel::notifyPolling(_pollingInstance);
+	}
+
+	//! \brief Add a batch of point-to-point operations to the pre-queues
+	//!
+	//! The operations are copied into the queue of the current CPU at once,
+	//! keeping their order. They are never prioritized
+	//!
+	//! \param operations The array of operations to add
+	//! \param count The number of operations
+	void addOperations(const Operation operations[], size_t count)
+	{
+		assert(count > 0);
+
+		_p2pOperations.push(operations, count);
+
+		// Wake up the polling task if it is parked
+		TaskingModel::notifyPolling(_pollingInstance);
+	}
+
+	//! \brief Add a collective operation to the pre-queues
+	//!
+	//! The collective operations do not fit in the queue segments, so they
+	//! are allocated separately and freed once issued
+	//!
+	//! \param operation The collective operation to add
+	void addOperation(CollOperation *operation)
 	{
 		assert(operation != nullptr);
 
-		if constexpr (std::is_same_v<T, Operation>) {
-			_p2pOperations.push(operation);
-		} else {
-			_collOperations.push(operation);
+		_collOperations.push(operation);
+
+		// Wake up the polling task if it is parked
+		TaskingModel::notifyPolling(_pollingInstance);
+	}
+
+	//! \brief Start a partitioned request
+	//!
+	//! The request is started directly by the calling task, so its partitions
+	//! can be marked as ready right after. The polling task checks the request
+	//! until the round completes. If the previous round is still completing,
+	//! the polling task starts the request once it completes, and the events
+	//! of the calling task are fulfilled then
+	//!
+	//! \param request The partitioned request
+	void startPartitioned(request_t request)
+	{
+		_partitionCtrl.start(request, TaskContext(false));
+
+		// Wake up the polling task if it is parked
+		TaskingModel::notifyPolling(_pollingInstance);
+	}
+
+	//! \brief Free a partitioned request
+	//!
+	//! \param request The partitioned request; set to the null request
+	void freePartitioned(request_t &request)
+	{
+		_partitionCtrl.free(request);
+	}
+
+	//! \brief Mark a partition as ready from the calling task
+	//!
+	//! The events of the calling task are bound to the completion of the
+	//! round of the partitioned request
+	//!
+	//! \param request The partitioned send request
+	//! \param partition The partition
+	void readyPartition(request_t request, int partition)
+	{
+		_partitionCtrl.ready(request, partition, TaskContext(false));
+	}
+
+	//! \brief Bind the calling task to the arrival of a partition
+	//!
+	//! \param request The partitioned receive request
+	//! \param partition The partition
+	void waitPartition(request_t request, int partition)
+	{
+		if (_partitionCtrl.arrived(request, partition, TaskContext(false))) {
+			// Wake up the polling task if it is parked
+			TaskingModel::notifyPolling(_pollingInstance);
 		}
 	}
 
+	//! \brief Set the polling instance that checks this ticket manager
+	//!
+	//! \param instance The polling instance
+	void setPollingInstance(TaskingModel::PollingInstance *instance)
+	{
+		_pollingInstance = instance;
+	}
+
+	//! \brief Indicate whether operations can be issued directly
+	bool isDirectIssueEnabled() const
+	{
+		return (_directIssueThreshold > 0);
+	}
+
+	//! \brief Try to issue a point-to-point operation from the calling task
+	//!
+	//! The operation is issued directly if it is small enough, the ticket
+	//! manager is not busy and there are no point-to-point operations in the
+	//! pre-queues, which could be overtaken otherwise. The request is tested
+	//! immediately and is only transferred to the general arrays if it is
+	//! still pending. In that case, the events of the calling task are bound
+	//! before transferring the request
+	//!
+	//! \param operation The operation to issue
+	//!
+	//! \returns Whether the operation was not issued, completed or is pending
+	DirectIssueResult directIssue(Operation &operation);
+
 private:
-	//! \brief Check the in-flight requests
+	//! \brief Create the ticket managers of all shards
+	static TicketManager *createShards()
+	{
+		size_t nshards = Sharding::getNumShards();
+
+		TicketManager *managers = new TicketManager[nshards];
+		for (size_t s = 0; s < nshards; ++s)
+			managers[s]._shard = s;
+
+		return managers;
+	}
+
+	//! \brief Parse the pop policy of the point-to-point pre-queues
+	static MultiQueuePopPolicy parsePopPolicy(const std::string &name)
+	{
+		EnvironmentVariable<std::string> value(name, "cyclic");
+
+		if (value.get() == "cyclic")
+			return MultiQueuePopPolicy::CyclicRoundRobin;
+		if (value.get() == "block")
+			return MultiQueuePopPolicy::BlockRoundRobin;
+		if (value.get() == "oldest")
+			return MultiQueuePopPolicy::OldestFirst;
+
+		ErrorHandler::fail(name, " has invalid value");
+
+		return MultiQueuePopPolicy::CyclicRoundRobin;
+	}
+
+	//! \brief Check the in-flight requests of a tier
+	//!
+	//! \param tier The tier to check
+	//!
+	//! \returns The number of requests completed
+	int internalCheckRequests(RequestTier &tier);
+
+	//! \brief Check the cold tier and demote the aged hot requests
+	//!
+	//! This function assumes the lock is already acquired and the tiering
+	//! is enabled
 	//!
 	//! \returns The number of requests completed
-	int internalCheckRequests();
+	int internalCheckTiers();
+
+	//! \brief Insert an in-flight request into a tier
+	//!
+	//! \param tier The tier
+	//! \param request The request
+	//! \param ticket The ticket to copy and associate with the request
+	//! \param flow The flow control information of the request
+	void insertRequest(RequestTier &tier, request_t &request, const Ticket &ticket, const Flow &flow = Flow())
+	{
+		tier.arrays.reserve(tier.pending + 1);
+
+		tier.arrays.allocateTicket(tier.pending, ticket);
+		tier.arrays.associateRequest(tier.pending, request, 0);
+		tier.arrays.setEpoch(tier.pending, _tieringCtrl.getEpoch());
+		tier.arrays.setFlow(tier.pending, flow);
+		++tier.pending;
+		++_pending;
+	}
+
+	//! \brief Remove requests from a tier and keep its arrays compact
+	//!
+	//! \param tier The tier
+	//! \param indices The ascending positions of the requests to remove
+	//! \param count The number of requests to remove
+	static void compactRequests(RequestTier &tier, const int *indices, int count);
 
 	static int internalTestRequests(TestingApproach approach, int count, request_t *requests, int *indices, status_ptr_t statuses)
 	{
@@ -198,50 +464,56 @@ private:
 
 	//! \brief Internal function to check and transfer operations from pre-queues
 	//!
-	//! This function assumes the lock is already acquired
+	//! This function assumes the lock is already acquired. The sends held by
+	//! the flow control are released first, and the new point-to-point
+	//! operations are transferred only if the flow control admits them
 	//!
 	//! \param max Maximum operations to transfer
 	int internalCheckOperationQueues(int max);
 
+	//! \brief Transfers the point-to-point operations admitted by the flow
+	//! control to the general array and holds the rest
+	//!
+	//! \param operations The array of operations
+	//! \param count The number of operations
+	//!
+	//! \returns The number of operations transferred
+	int admitOperations(Operation operations[], int count);
+
 	//! \brief Transfers operations to the general array
 	//!
+	//! The point-to-point operations are passed by value and the collective
+	//! ones by pointer, which are freed after being issued
+	//!
 	//! \param operations The array of operations to transfer
 	//! \param count The number of operations to transfer
+	//! \param flows The flow control information of the operations or nullptr
 	template <typename OperationTy>
-	void transferOperations(OperationTy *operations[], int count);
-
-	//! \brief Parse request testing option
-	static TestingApproach parseTestingOption(
-		const std::string &name, TestingApproach defaultValue
-	) {
-		EnvironmentVariable<std::string> value(name);
-
-		if (!value.isPresent())
-			return defaultValue;
-
-		if (value.get() == "testsome")
-			return TestingApproach::TestSome;
-		if (value.get() == "testany")
-			return TestingApproach::TestAny;
-		if (value.get() == "test")
-			return TestingApproach::Test;
-		if (value.get() == "none")
-			return TestingApproach::None;
+	void transferOperations(OperationTy operations[], int count, const Flow *flows = nullptr);
 
-		ErrorHandler::fail(name, " has invalid value");
+	//! \brief Get an operation from an entry of the transfer arrays
+	static Operation &getOperation(Operation &entry)
+	{
+		return entry;
+	}
 
-		return TestingApproach::None;
+	//! \brief Get an operation from an entry of the transfer arrays
+	static CollOperation &getOperation(CollOperation *entry)
+	{
+		assert(entry != nullptr);
+		return *entry;
 	}
 };
 
 template <typename Lang>
-inline int TicketManager<Lang>::internalCheckRequests()
+inline int TicketManager<Lang>::internalCheckRequests(RequestTier &tier)
 {
-	assert(_pending > 0);
+	assert(tier.pending > 0);
 
 	Instrument::Guard<CheckGlobalRequestArray> instrGuard;
 
-	int *indices = _arrays.getIndices();
+	Internals &arrays = tier.arrays;
+	int *indices = arrays.getIndices();
 	assert(indices != nullptr);
 
 	Uninitialized<TaskContext, BatchSize> contexts;
@@ -251,21 +523,28 @@ inline int TicketManager<Lang>::internalCheckRequests()
 	int checked = 0;
 	int completed = 0;
 	do {
-		int count = std::min(_pending - checked, BatchSize);
+		int count = std::min(tier.pending - checked, BatchSize);
+
+		TestingApproach approach = _testingCtrl.chooseGeneral(count);
+		uint64_t begin = _testingCtrl.beginGeneral();
 
-		int batchCompleted = internalTestRequests(_generalTesting,
-				count, _arrays.getRequests() + checked,
-				indices + completed, _arrays.getStatuses());
+		int batchCompleted = internalTestRequests(approach,
+				count, arrays.getRequests() + checked,
+				indices + completed, arrays.getStatuses());
+
+		_testingCtrl.endGeneral(approach, count, begin);
 
 		for (int c = 0; c < batchCompleted; ++c) {
 			// Correct indices to consider batch offset
 			indices[completed + c] += checked;
 
 			int index = indices[completed + c];
-			int local = _arrays.getLocalPositionInTicket(index);
-			Ticket &ticket = _arrays.getAssociatedTicket(index);
+			_flowCtrl.complete(arrays.getFlow(index));
+
+			int local = arrays.getLocalPositionInTicket(index);
+			Ticket &ticket = arrays.getAssociatedTicket(index);
 			if (!ticket.ignoreStatus())
-				ticket.storeStatus(_arrays.getStatus(c), local);
+				ticket.storeStatus(arrays.getStatus(c), local);
 
 			if (useCompletionManager) {
 				contexts[c] = ticket.getTaskContext();
@@ -278,16 +557,70 @@ inline int TicketManager<Lang>::internalCheckRequests()
 		}
 
 		if (useCompletionManager && batchCompleted > 0)
-			CompletionManager::transfer((TaskContext *) contexts, batchCompleted);
+			CompletionManager::transfer(_shard, (TaskContext *) contexts, batchCompleted);
 
 		checked += count;
 		completed += batchCompleted;
-	} while (checked < _pending);
+	} while (checked < tier.pending);
+
+	compactRequests(tier, indices, completed);
+	_pending -= completed;
+
+	return completed;
+}
+
+template <typename Lang>
+inline int TicketManager<Lang>::internalCheckTiers()
+{
+	RequestTier &hot = _tiers[Hot];
+	RequestTier &cold = _tiers[Cold];
+
+	int completed = 0;
+
+	// Test the cold tier when its decaying period expires
+	if (cold.pending && _tieringCtrl.mustCheckCold()) {
+		completed = internalCheckRequests(cold);
+		_tieringCtrl.evaluateCold(completed);
+	}
+
+	// Demote the hot requests that did not complete in time
+	int *indices = hot.arrays.getIndices();
+	int demoted = 0;
+	for (int r = 0; r < hot.pending; ++r) {
+		if (!_tieringCtrl.mustDemote(hot.arrays.getEpoch(r)))
+			continue;
+
+		cold.arrays.reserve(cold.pending + 1);
+
+		cold.arrays.allocateTicket(cold.pending, hot.arrays.getAssociatedTicket(r));
+		cold.arrays.associateRequest(cold.pending, hot.arrays.getRequest(r), hot.arrays.getLocalPositionInTicket(r));
+		cold.arrays.setEpoch(cold.pending, hot.arrays.getEpoch(r));
+		cold.arrays.setFlow(cold.pending, hot.arrays.getFlow(r));
+		++cold.pending;
+
+		indices[demoted++] = r;
+	}
+
+	if (demoted > 0)
+		compactRequests(hot, indices, demoted);
+
+	_tieringCtrl.advance();
 
-	// Perform smart replacement to keep the arrays compact
-	int replacement = _pending - 1;
-	int reverse = completed - 1;
-	for (int c = 0; c < completed; ++c) {
+	return completed;
+}
+
+template <typename Lang>
+inline void TicketManager<Lang>::compactRequests(RequestTier &tier, const int *indices, int count)
+{
+	// Release the slots of the removed requests before overwriting them
+	for (int c = 0; c < count; ++c)
+		tier.arrays.releaseRequest(indices[c]);
+
+	// Perform smart replacement to keep the arrays compact. Only the request
+	// handles and their slot indices are moved
+	int replacement = tier.pending - 1;
+	int reverse = count - 1;
+	for (int c = 0; c < count; ++c) {
 		const int current = indices[c];
 
 		bool replace = false;
@@ -301,13 +634,66 @@ inline int TicketManager<Lang>::internalCheckRequests()
 		}
 
 		if (replace) {
-			_arrays.moveRequest(replacement, current);
+			tier.arrays.moveRequest(replacement, current);
 			--replacement;
 		}
 	}
-	_pending -= completed;
+	tier.pending -= count;
+}
 
-	return completed;
+template <typename Lang>
+inline typename TicketManager<Lang>::DirectIssueResult
+TicketManager<Lang>::directIssue(Operation &operation)
+{
+	// The sends under flow control must go through the pre-queues
+	if (_flowCtrl.isControlled(operation))
+		return DirectIssueResult::NotIssued;
+
+	size_t size = operation._count * Interface<Lang>::typeSize(operation._datatype);
+	if (size > _directIssueThreshold)
+		return DirectIssueResult::NotIssued;
+
+	// Do not wait for the polling task
+	if (!_mutex.try_lock())
+		return DirectIssueResult::NotIssued;
+
+	std::lock_guard<SpinLock> guard(_mutex, std::adopt_lock);
+
+	if (_pending >= _capacityCtrl.get() || !_p2pPriorityOperations.empty() || !_p2pOperations.empty())
+		return DirectIssueResult::NotIssued;
+
+	Ticket ticket(operation);
+
+	// Issue the non-blocking MPI operation
+	Instrument::enter<IssueNonBlockingOp>();
+	request_t request = operation.issue();
+	Instrument::exit<IssueNonBlockingOp>();
+
+	// Some Intel MPI libraries return MPI_REQUEST_NULL directly
+	if (request == Interface<Lang>::REQUEST_NULL)
+		return DirectIssueResult::Completed;
+
+	status_t status;
+	int index;
+	TestingApproach approach = _testingCtrl.chooseImmediate(1);
+	int completed = internalTestRequests(approach, 1, &request, &index, (status_ptr_t) &status);
+	_testingCtrl.evaluateImmediate(approach, 1, completed);
+
+	if (completed) {
+		if (!ticket.ignoreStatus())
+			ticket.storeStatus(status, 0);
+		return DirectIssueResult::Completed;
+	}
+
+	// Bind the event before the polling task can complete the request
+	TaskContext context = ticket.getTaskContext();
+	context.bindEvents(1);
+	insertRequest(_tiers[Hot], request, ticket);
+
+	// Wake up the polling task if it is parked
+	TaskingModel::notifyPolling(_pollingInstance);
+
+	return DirectIssueResult::Pending;
 }
 
 template <typename Lang>
@@ -315,20 +701,37 @@ inline int TicketManager<Lang>::internalCheckOperationQueues(int max)
 {
 	Instrument::Guard<TransferQueues> instrGuard;
 
-	Operation *tmpP2POps[BatchSize];
+	Operation tmpP2POps[BatchSize];
 	CollOperation *tmpCollOps[BatchSize];
+	Flow tmpFlows[BatchSize];
 
 	const int navailable = std::min(_capacityCtrl.get() - _pending, max);
-	int np2p, ncoll;
+	int nprio, np2p, ncoll;
 	int ntotal = 0;
 
+	// Release the held sends first to keep their order
+	if (_flowCtrl.getNumHeld() > 0) {
+		do {
+			np2p = std::min(navailable - ntotal, BatchSize);
+			np2p = _flowCtrl.release(tmpP2POps, tmpFlows, np2p);
+			if (np2p > 0) {
+				transferOperations(tmpP2POps, np2p, tmpFlows);
+				ntotal += np2p;
+			}
+		} while (ntotal < navailable && np2p > 0);
+	}
+
 	do {
+		// Issue the high-priority operations before the rest
+		nprio = std::min(navailable - ntotal, BatchSize);
+		nprio = _p2pPriorityOperations.pop(tmpP2POps, nprio);
+		if (nprio > 0)
+			ntotal += admitOperations(tmpP2POps, nprio);
+
 		np2p = std::min(navailable - ntotal, BatchSize);
 		np2p = _p2pOperations.pop(tmpP2POps, np2p);
-		if (np2p > 0) {
-			transferOperations(tmpP2POps, np2p);
-			ntotal += np2p;
-		}
+		if (np2p > 0)
+			ntotal += admitOperations(tmpP2POps, np2p);
 
 		ncoll = std::min(navailable - ntotal, BatchSize);
 		ncoll = _collOperations.pop(tmpCollOps, ncoll);
@@ -336,14 +739,40 @@ inline int TicketManager<Lang>::internalCheckOperationQueues(int max)
 			transferOperations(tmpCollOps, ncoll);
 			ntotal += ncoll;
 		}
-	} while (ntotal < navailable && (np2p > 0 || ncoll > 0));
+	} while (ntotal < navailable && (nprio > 0 || np2p > 0 || ncoll > 0));
 
 	return ntotal;
 }
 
+template <typename Lang>
+inline int TicketManager<Lang>::admitOperations(Operation operations[], int count)
+{
+	if (!_flowCtrl.isEnabled()) {
+		transferOperations(operations, count);
+		return count;
+	}
+
+	Flow flows[BatchSize];
+
+	// Keep the admitted operations and hold the rest
+	int nadmitted = 0;
+	for (int o = 0; o < count; ++o) {
+		if (_flowCtrl.admit(operations[o], flows[nadmitted])) {
+			if (o != nadmitted)
+				operations[nadmitted] = operations[o];
+			++nadmitted;
+		}
+	}
+
+	if (nadmitted > 0)
+		transferOperations(operations, nadmitted, flows);
+
+	return nadmitted;
+}
+
 template <typename Lang>
 template <typename OperationTy>
-inline void TicketManager<Lang>::transferOperations(OperationTy *operations[], int count)
+inline void TicketManager<Lang>::transferOperations(OperationTy operations[], int count, const Flow *flows)
 {
 	assert(count <= BatchSize);
 	assert(_pending + count <= _capacityCtrl.get());
@@ -368,12 +797,12 @@ inline void TicketManager<Lang>::transferOperations(OperationTy *operations[], i
 	for (int e = 0; e < count; ++e) {
 		// Construct the temporary ticket
 		Instrument::enter<CreateTicket>();
-		new (&tickets[e]) Ticket(*operations[e]);
+		new (&tickets[e]) Ticket(getOperation(operations[e]));
 		Instrument::exit<CreateTicket>();
 
 		// Issue the non-blocking MPI operation
 		Instrument::enter<IssueNonBlockingOp>();
-		requests[nreqs] = operations[e]->issue();
+		requests[nreqs] = getOperation(operations[e]).issue();
 		if (requests[nreqs] != Interface<Lang>::REQUEST_NULL) {
 			req2entry[nreqs++] = e;
 		} else {
@@ -384,9 +813,12 @@ inline void TicketManager<Lang>::transferOperations(OperationTy *operations[], i
 	}
 
 	// Check the completion of the pending requests
-	if (nreqs)
-		ntestcompl = internalTestRequests(_immediateTesting, nreqs,
+	if (nreqs) {
+		TestingApproach approach = _testingCtrl.chooseImmediate(nreqs);
+		ntestcompl = internalTestRequests(approach, nreqs,
 				requests, testcompl2req, (status_ptr_t) statuses);
+		_testingCtrl.evaluateImmediate(approach, nreqs, ntestcompl);
+	}
 
 	// Filter our the immediately completed operations
 	for (int c = 0; c < ntestcompl; ++c) {
@@ -406,6 +838,9 @@ inline void TicketManager<Lang>::transferOperations(OperationTy *operations[], i
 		int entry = complentries[c];
 		Ticket &ticket = tickets[entry];
 
+		if (flows != nullptr)
+			_flowCtrl.complete(flows[entry]);
+
 		// Delegate the completion or process it directly
 		if (useCompletionManager) {
 			contexts[c] = ticket.getTaskContext();
@@ -418,22 +853,26 @@ inline void TicketManager<Lang>::transferOperations(OperationTy *operations[], i
 
 	// Send the completed tickets to the completion task (if needed)
 	if (useCompletionManager && ncompl > 0)
-		CompletionManager::transfer((TaskContext *) contexts, ncompl);
+		CompletionManager::transfer(_shard, (TaskContext *) contexts, ncompl);
 
-	// Move the pending tickets to the global array
+	// Collective requests usually take longer, so place them directly in
+	// the cold tier when the tiering is enabled
+	RequestTier &tier = (std::is_same_v<OperationTy, CollOperation *> && _tieringCtrl.isEnabled())
+		? _tiers[Cold] : _tiers[Hot];
+
+	// Move the pending tickets to the general arrays
 	for (int r = 0; r < nreqs; ++r) {
 		int entry = req2entry[r];
 		if (entry < 0)
 			continue;
 
 		// Allocate a copy of the ticket and associate it with the request
-		Ticket &ticket = _arrays.allocateTicket(_pending, tickets[entry]);
-		_arrays.associateRequest(_pending, requests[r], ticket, 0);
-		++_pending;
+		insertRequest(tier, requests[r], tickets[entry], (flows != nullptr) ? flows[entry] : Flow());
 	}
 
-	// Free the processed operations
-	Allocator::free(operations, count);
+	// Free the processed collective operations
+	if constexpr (std::is_same_v<OperationTy, CollOperation *>)
+		Allocator::free(operations, count);
 }
 
 } // namespace tampi
@@ -1,27 +1,57 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef TICKET_MANAGER_CAPACITY_CTRL_HPP
 #define TICKET_MANAGER_CAPACITY_CTRL_HPP
 
+#include <algorithm>
+#include <climits>
 #include <cstdint>
 #include <vector>
 #include <sstream>
 #include <string>
+#include <tuple>
 
 #include "util/Clock.hpp"
 #include "util/EnvironmentVariable.hpp"
 
 namespace tampi {
 
-//! Class that controls the capacity of the ticket manager capacity
+//! Class that controls the capacity of the ticket manager capacity. The
+//! default policy only doubles the capacity when the ticket manager stalls
+//! at full capacity. The AIMD policy additively increases the capacity while
+//! it is saturated and requests keep completing, and multiplicatively
+//! decreases it when it is underused or when the completion rate drops
+//! despite being saturated
 class TicketManagerCapacityCtrl {
 private:
-	//! Hard limit of in-flight requests
-	static constexpr uint64_t CapacityLimit = 32*1024;
+	//! Default maximum number of in-flight requests
+	static constexpr uint64_t DefaultCapacityMax = 32*1024;
+
+	//! Upper bound that keeps the request counters within an int
+	static constexpr uint64_t CapacityLimit = INT_MAX / 2;
+
+	//! The number of consecutive underused windows before decreasing
+	static constexpr uint64_t UnderuseWindows = 10;
+
+	//! The fraction of the capacity under which a window is underused
+	static constexpr uint64_t UnderuseDivisor = 4;
+
+	//! The fraction of the last completion rate under which a saturated
+	//! window decreases the capacity
+	static constexpr double RateDropFactor = 0.75;
+
+	//! The policies to control the capacity
+	enum class Policy {
+		Double = 0,
+		AIMD
+	};
+
+	//! The policy to control the capacity
+	Policy _policy;
 
 	//! The minimum and maximum capacity
 	uint64_t _capacityMin;
@@ -42,23 +72,53 @@ private:
 	//! The timestamp (in ms) when the saturation epoch began (if any)
 	double _saturationBegin;
 
+	//! The timestamp (in ms) when the current AIMD window began
+	double _windowBegin;
+
+	//! The number of completed requests in the current AIMD window
+	uint64_t _windowCompleted;
+
+	//! The maximum number of pending requests in the current AIMD window
+	uint64_t _windowPeak;
+
+	//! Indicate whether the capacity was saturated in the current AIMD window
+	bool _windowSaturated;
+
+	//! The completion rate (per ms) of the last AIMD window if saturated
+	double _lastRate;
+
+	//! The number of consecutive underused AIMD windows
+	uint64_t _underused;
+
 public:
 	TicketManagerCapacityCtrl() :
+		_policy(Policy::Double),
 		_capacityMin(128),
-		_capacityMax(CapacityLimit),
+		_capacityMax(DefaultCapacityMax),
 		_dynamic(true),
 		_capacity(_capacityMin),
 		_timeout(10),
-		_saturation(false)
+		_saturation(false),
+		_windowBegin(0),
+		_windowCompleted(0),
+		_windowPeak(0),
+		_windowSaturated(false),
+		_lastRate(0),
+		_underused(0)
 	{
 		EnvironmentVariable<std::string> policy("TAMPI_CAPACITY");
 		EnvironmentVariable<uint64_t> timeout("TAMPI_CAPACITY_TIMEOUT");
 
 		if (policy.isPresent()) {
-			auto [min, max] = parseCapacities(policy.get());
+			auto [min, max, name] = parseCapacities(policy.get());
 			if (min > max)
 				ErrorHandler::fail("Minimum capacity cannot be greater than maximum");
 
+			if (name == "aimd")
+				_policy = Policy::AIMD;
+			else if (name != "double")
+				ErrorHandler::fail("TAMPI_CAPACITY has an invalid policy '", name, "'");
+
 			_capacityMin = std::min(min, CapacityLimit);
 			_capacityMax = std::min(max, CapacityLimit);
 			_capacity = _capacityMin;
@@ -74,11 +134,6 @@ public:
 		return _capacity;
 	}
 
-	constexpr static inline int max()
-	{
-		return CapacityLimit;
-	}
-
 	//! \brief Evaluate whether the capacity must be modified
 	//!
 	//! This function decides which should be capacity of the ticket manager,
@@ -90,10 +145,28 @@ public:
 	//! \param pending The number of pending requests
 	//! \param completed The number of completed requests
 	inline void evaluate(uint64_t pending, uint64_t completed)
+	{
+		if (!_dynamic)
+			return;
+
+		if (_policy == Policy::AIMD)
+			evaluateAIMD(pending, completed);
+		else
+			evaluateSaturation(pending, completed);
+	}
+
+private:
+	//! \brief Double the capacity if it stalls at its maximum
+	//!
+	//! \param pending The number of pending requests
+	//! \param completed The number of completed requests
+	//!
+	//! \returns Whether the capacity was increased
+	inline bool evaluateSaturation(uint64_t pending, uint64_t completed)
 	{
 		// Nothing to do if the maximum capacity was reached
 		if (_capacity == _capacityMax)
-			return;
+			return false;
 
 		// The saturation protocol should be enabled while we are in the maximum
 		// capacity and we find no completed requests. Once this condition persists
@@ -110,19 +183,99 @@ public:
 				_saturation = false;
 				_capacity = std::min(_capacity * 2, _capacityMax);
 				ErrorHandler::warn("Increasing capacity to ", _capacity);
+				return true;
 			}
 		} else {
 			// Disable saturation protocol
 			_saturation = false;
 		}
+		return false;
+	}
+
+	//! \brief Evaluate the capacity with the AIMD policy
+	//!
+	//! The statistics are accumulated in windows of the saturation timeout.
+	//! The doubling on stalls is kept to avoid communication deadlocks
+	//!
+	//! \param pending The number of pending requests
+	//! \param completed The number of completed requests
+	inline void evaluateAIMD(uint64_t pending, uint64_t completed)
+	{
+		double now = Clock::now_ms();
+		if (_windowBegin == 0)
+			_windowBegin = now;
+
+		_windowCompleted += completed;
+		_windowPeak = std::max(_windowPeak, pending);
+		_windowSaturated |= (pending >= _capacity);
+
+		if (evaluateSaturation(pending, completed)) {
+			resetWindow(now, 0);
+			return;
+		}
+
+		double elapsed = now - _windowBegin;
+		if (elapsed < _timeout)
+			return;
+
+		double rate = _windowCompleted / std::max(elapsed, 1.0);
+
+		if (_windowSaturated) {
+			_underused = 0;
+			if (_lastRate > 0 && rate < _lastRate * RateDropFactor) {
+				// Completing less despite having more requests in-flight
+				decrease("completion rate dropped");
+			} else if (_windowCompleted > 0 && _capacity < _capacityMax) {
+				// Additive increase while requests keep completing
+				_capacity = std::min(_capacity + _capacityMin, _capacityMax);
+			}
+		} else if (_windowPeak < _capacity / UnderuseDivisor) {
+			if (++_underused >= UnderuseWindows) {
+				decrease("capacity underused");
+				_underused = 0;
+			}
+		} else {
+			_underused = 0;
+		}
+
+		// Only compare the rates of consecutive saturated windows
+		resetWindow(now, _windowSaturated ? rate : 0);
 	}
 
+	//! \brief Multiplicatively decrease the capacity
+	//!
+	//! \param reason The reason of the decrease
+	inline void decrease(const char *reason)
+	{
+		uint64_t capacity = std::max(_capacity / 2, _capacityMin);
+		if (capacity == _capacity)
+			return;
+
+		_capacity = capacity;
+		_saturation = false;
+		ErrorHandler::warn("Decreasing capacity to ", _capacity, " (", reason, ")");
+	}
+
+	//! \brief Begin a new AIMD window
+	//!
+	//! \param now The current timestamp (in ms)
+	//! \param rate The completion rate of the finished window
+	inline void resetWindow(double now, double rate)
+	{
+		_windowBegin = now;
+		_windowCompleted = 0;
+		_windowPeak = 0;
+		_windowSaturated = false;
+		_lastRate = rate;
+	}
+
+public:
 	//! \brief Parse the capacity policy string
 	//!
 	//! \param policy The policy string
 	//!
-	//! \returns a pair with the minimum and maximum capacities
-	static inline std::pair<uint64_t, uint64_t> parseCapacities(
+	//! \returns a tuple with the minimum and maximum capacities and the policy
+	static inline std::tuple<uint64_t, uint64_t, std::string> parseCapacities(
 		const std::string &policy
 	) {
 		std::string component;
@@ -131,8 +284,8 @@ public:
 		while (std::getline(stream, component, ':'))
 			components.push_back(component);
 
-		if (components.size() < 1 || components.size() > 2)
-			ErrorHandler::fail("TAMPI_CAPACITY has format '<min capacity>[:<max capacity>]'");
+		if (components.size() < 1 || components.size() > 3)
+			ErrorHandler::fail("TAMPI_CAPACITY has format '<min capacity>[:<max capacity>[:<policy>]]'");
 
 		uint64_t min, max;
 		std::istringstream(components[0]) >> min;
@@ -141,7 +294,11 @@ public:
 		else
 			max = min;
 
-		return { min, max };
+		std::string name = "double";
+		if (components.size() > 2)
+			name = components[2];
+
+		return { min, max, name };
 	}
 };
 
@@ -0,0 +1,289 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef TICKET_MANAGER_FLOW_CTRL_HPP
+#define TICKET_MANAGER_FLOW_CTRL_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "Interface.hpp"
+#include "Operation.hpp"
+#include "util/Clock.hpp"
+#include "util/EnvironmentVariable.hpp"
+
+namespace tampi {
+
+//! Class that controls the flow of the send operations issued by the ticket
+//! manager. It limits the number of in-flight sends per destination and the
+//! number of in-flight bytes globally. The sends over the limits are held in
+//! a per-destination FIFO, preserving the MPI message ordering, while the
+//! operations to other destinations go ahead. A held send is released after
+//! a timeout without progress on its destination to avoid communication
+//! deadlocks
+template <typename Lang>
+class TicketManagerFlowCtrl {
+private:
+	typedef typename Types<Lang>::comm_t comm_t;
+	typedef typename Types<Lang>::int_t int_t;
+	typedef tampi::Operation<Lang> Operation;
+
+	//! The key identifying a destination
+	struct PeerKey {
+		comm_t comm;
+		int_t rank;
+
+		bool operator==(const PeerKey &other) const
+		{
+			return comm == other.comm && rank == other.rank;
+		}
+	};
+
+	//! The hash function of the destination keys
+	struct PeerKeyHash {
+		size_t operator()(const PeerKey &key) const
+		{
+			return std::hash<uint64_t>()((uint64_t) (uintptr_t) key.comm) ^ ((size_t) key.rank << 1);
+		}
+	};
+
+public:
+	//! The state of a destination
+	struct Peer {
+		//! The key of the destination
+		PeerKey key;
+
+		//! The number of in-flight sends
+		uint64_t inflight;
+
+		//! The held sends and their sizes in bytes
+		std::deque<std::pair<Operation, uint64_t>> held;
+
+		//! The timestamp (in ms) of the last progress while holding sends,
+		//! i.e., the first held send, the last completion or forced release
+		double lastProgress;
+
+		Peer(const PeerKey &peerKey) : key(peerKey), inflight(0), held(), lastProgress(0)
+		{
+		}
+	};
+
+	//! The flow information of an in-flight operation
+	struct Flow {
+		//! The destination or nullptr if not controlled
+		Peer *peer;
+
+		//! The size of the operation in bytes
+		uint64_t bytes;
+	};
+
+private:
+	//! The maximum number of in-flight sends per destination
+	uint64_t _peerCapacity;
+
+	//! The maximum number of in-flight bytes
+	uint64_t _bytesCapacity;
+
+	//! The current number of in-flight bytes
+	uint64_t _inflightBytes;
+
+	//! The number of held sends; only modified by the polling task
+	std::atomic<size_t> _nheld;
+
+	//! The maximum time (in ms) without progress on a destination while
+	//! holding its sends
+	uint64_t _timeout;
+
+	//! The destinations with in-flight or held sends; the references are
+	//! stable and a destination is erased once it has neither
+	std::unordered_map<PeerKey, Peer, PeerKeyHash> _peers;
+
+	//! The destinations with held sends
+	std::deque<Peer *> _heldPeers;
+
+public:
+	TicketManagerFlowCtrl() :
+		_peerCapacity(EnvironmentVariable<uint64_t>("TAMPI_PEER_CAPACITY", 0)),
+		_bytesCapacity(EnvironmentVariable<uint64_t>("TAMPI_BYTES_CAPACITY", 0)),
+		_inflightBytes(0),
+		_nheld(0),
+		_timeout(EnvironmentVariable<uint64_t>("TAMPI_CAPACITY_TIMEOUT", 10)),
+		_peers(),
+		_heldPeers()
+	{
+	}
+
+	//! \brief Indicate whether the flow control is enabled
+	inline bool isEnabled() const
+	{
+		return (_peerCapacity > 0 || _bytesCapacity > 0);
+	}
+
+	//! \brief Get the number of held operations
+	//!
+	//! This function can be called from any thread
+	inline size_t getNumHeld() const
+	{
+		return _nheld.load(std::memory_order_acquire);
+	}
+
+	//! \brief Indicate whether an operation is subject to the flow control
+	//!
+	//! \param operation The operation
+	inline bool isControlled(const Operation &operation) const
+	{
+		if (!isEnabled())
+			return false;
+
+		switch (operation._code) {
+			case BSEND:
+			case RSEND:
+			case SEND:
+			case SSEND:
+			case STARTSEND:
+				return true;
+			default:
+				return false;
+		}
+	}
+
+	//! \brief Admit an operation or hold a copy of it
+	//!
+	//! \param operation The operation
+	//! \param flow The flow information to fill if admitted
+	//!
+	//! \returns Whether the operation can be issued now
+	inline bool admit(const Operation &operation, Flow &flow)
+	{
+		flow = { nullptr, 0 };
+		if (!isControlled(operation))
+			return true;
+
+		PeerKey key{ operation._comm, operation._rank };
+		Peer &peer = _peers.try_emplace(key, key).first->second;
+		uint64_t bytes = operation._count * Interface<Lang>::typeSize(operation._datatype);
+
+		// Keep the order with the sends already held
+		if (!peer.held.empty() || !fits(peer, bytes)) {
+			if (peer.held.empty()) {
+				_heldPeers.push_back(&peer);
+				peer.lastProgress = Clock::now_ms();
+			}
+
+			peer.held.emplace_back(operation, bytes);
+			_nheld.store(_nheld.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+			return false;
+		}
+
+		acquire(peer, bytes, flow);
+		return true;
+	}
+
+	//! \brief Release the held operations that fit within the limits
+	//!
+	//! \param operations The array to store the released operations
+	//! \param flows The array to store the flows of the released operations
+	//! \param max The maximum number of operations to release
+	//!
+	//! \returns The number of released operations
+	inline size_t release(Operation operations[], Flow flows[], size_t max)
+	{
+		if (_nheld.load(std::memory_order_relaxed) == 0)
+			return 0;
+
+		const double now = Clock::now_ms();
+
+		size_t released = 0;
+		size_t npeers = _heldPeers.size();
+		for (size_t p = 0; p < npeers && released < max; ++p) {
+			Peer *peer = _heldPeers.front();
+			_heldPeers.pop_front();
+
+			// Force the release of one operation if there is no progress on
+			// the destination, even if the other destinations progress
+			bool force = (now - peer->lastProgress > _timeout);
+
+			while (released < max && !peer->held.empty()) {
+				uint64_t bytes = peer->held.front().second;
+				if (!force && !fits(*peer, bytes))
+					break;
+
+				operations[released] = peer->held.front().first;
+				peer->held.pop_front();
+				_nheld.store(_nheld.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+
+				// Wait for another timeout before forcing again
+				if (force) {
+					peer->lastProgress = now;
+					force = false;
+				}
+
+				acquire(*peer, bytes, flows[released++]);
+			}
+
+			// Rotate the destinations for fairness
+			if (!peer->held.empty())
+				_heldPeers.push_back(peer);
+		}
+		return released;
+	}
+
+	//! \brief Account the completion of an operation
+	//!
+	//! \param flow The flow information of the operation
+	inline void complete(const Flow &flow)
+	{
+		if (flow.peer == nullptr)
+			return;
+
+		assert(flow.peer->inflight > 0);
+		assert(_inflightBytes >= flow.bytes);
+
+		--flow.peer->inflight;
+		_inflightBytes -= flow.bytes;
+		flow.peer->lastProgress = Clock::now_ms();
+
+		// Forget the destinations without in-flight nor held sends. No flow
+		// points to them since they have no in-flight sends. The key is
+		// copied since it is destroyed with the destination
+		if (flow.peer->inflight == 0 && flow.peer->held.empty()) {
+			PeerKey key = flow.peer->key;
+			_peers.erase(key);
+		}
+	}
+
+private:
+	//! \brief Check whether a send fits within the limits
+	//!
+	//! A send always fits if there are no in-flight bytes to avoid holding
+	//! the sends larger than the limit forever
+	inline bool fits(const Peer &peer, uint64_t bytes) const
+	{
+		if (_peerCapacity > 0 && peer.inflight >= _peerCapacity)
+			return false;
+		if (_bytesCapacity > 0 && _inflightBytes > 0 && _inflightBytes + bytes > _bytesCapacity)
+			return false;
+		return true;
+	}
+
+	//! \brief Account a send as in-flight
+	inline void acquire(Peer &peer, uint64_t bytes, Flow &flow)
+	{
+		++peer.inflight;
+		_inflightBytes += bytes;
+		flow = { &peer, bytes };
+	}
+};
+
+} // namespace tampi
+
+#endif // TICKET_MANAGER_FLOW_CTRL_HPP
@@ -1,83 +1,122 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef TICKET_MANAGER_INTERNALS_HPP
 #define TICKET_MANAGER_INTERNALS_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 #include <utility>
 
 #include "Ticket.hpp"
+#include "TicketManagerFlowCtrl.hpp"
+#include "util/ErrorHandler.hpp"
 
 namespace tampi {
 
-//! Class that provides storage for requests and tickets
-template <typename Lang, size_t Capacity>
+//! Class that provides storage for requests and tickets. The requests are
+//! kept in a dense array of positions, which is the one passed to the MPI
+//! testing functions, and each position refers to a stable slot holding the
+//! ticket and the rest of metadata of the request. Compacting the positions
+//! only moves the request handles and the slot indices, while the slots stay
+//! in place until the request is released. The arrays start empty and grow
+//! in chunks on demand, so their size follows the peak number of in-flight
+//! requests instead of the maximum capacity
+template <typename Lang>
 class TicketManagerInternals {
 private:
+	//! The granularity (in requests) of the array growth
+	static constexpr size_t ChunkSize = 1024;
+
 	typedef typename Types<Lang>::request_t request_t;
 	typedef typename Types<Lang>::status_t status_t;
 	typedef typename Types<Lang>::status_ptr_t status_ptr_t;
 	typedef tampi::Ticket<Lang> Ticket;
+	typedef typename TicketManagerFlowCtrl<Lang>::Flow Flow;
 
-	//! Structure to map requests and tickets. Notice that
-	//! a ticket may be associated to multiple requests
-	struct Mapping {
-		//! The associated request
-		Ticket *ticket;
-
-		//! The position of the request in the ticket
-		int localPosition;
-	};
-
-	//! The array of requests
+	//! The array of requests; indexed by position
 	request_t *_requests;
 
-	//! The array of statuses
+	//! The array of slots of the requests; indexed by position
+	int       *_slots;
+
+	//! The array of statuses of the completed requests
 	status_t  *_statuses;
 
-	//! The array of mappings between tickets and requests
-	Mapping   *_mappings;
+	//! Auxiliary array of indices used when checking requests
+	int *_indices;
 
-	//! The array of tickets
+	//! The array of tickets; indexed by slot
 	Ticket    *_tickets;
 
-	//! Auxiliary array of indices used when checking requests
-	int *_indices;
+	//! The array of positions of the requests in their tickets; indexed by slot
+	int       *_localPositions;
+
+	//! The array of poll epochs when the requests were inserted; indexed by slot
+	uint64_t *_epochs;
+
+	//! The array of flow control information of the requests; indexed by slot
+	Flow *_flows;
+
+	//! The stack of free slots
+	int *_freeSlots;
+
+	//! The number of free slots
+	size_t _nfree;
+
+	//! The current capacity of the arrays
+	size_t _capacity;
 
 public:
-	TicketManagerInternals()
+	TicketManagerInternals() :
+		_requests(nullptr),
+		_slots(nullptr),
+		_statuses(nullptr),
+		_indices(nullptr),
+		_tickets(nullptr),
+		_localPositions(nullptr),
+		_epochs(nullptr),
+		_flows(nullptr),
+		_freeSlots(nullptr),
+		_nfree(0),
+		_capacity(0)
 	{
-		// Allocate all arrays
-		_requests = (request_t *) std::malloc(Capacity * sizeof(request_t));
-		_statuses =  (status_t *) std::malloc(Capacity * sizeof(status_t));
-		_mappings =   (Mapping *) std::malloc(Capacity * sizeof(Mapping));
-		_tickets  =    (Ticket *) std::malloc(Capacity * sizeof(Ticket));
-		_indices  =       (int *) std::malloc(Capacity * sizeof(int));
-		assert(_requests && _statuses && _mappings && _tickets && _indices);
 	}
 
 	~TicketManagerInternals()
 	{
 		// Deallocate all arrays
-		assert(_requests && _statuses && _mappings && _tickets);
 		std::free(_requests);
+		std::free(_slots);
 		std::free(_statuses);
-		std::free(_mappings);
-		std::free(_tickets);
 		std::free(_indices);
+		std::free(_tickets);
+		std::free(_localPositions);
+		std::free(_epochs);
+		std::free(_flows);
+		std::free(_freeSlots);
 	}
 
-	//! \brief Get the maximum capacity of the arrays
+	//! \brief Get the current capacity of the arrays
 	//!
 	//! \returns The capacity
 	size_t capacity() const
 	{
-		return Capacity;
+		return _capacity;
+	}
+
+	//! \brief Ensure the arrays can store a number of requests
+	//!
+	//! \param count The number of requests
+	inline void reserve(size_t count)
+	{
+		if (count > _capacity)
+			grow(count);
 	}
 
 	//! \brief Get a request from the array
@@ -100,9 +139,9 @@ public:
 		return _requests[position];
 	}
 
-	//! \brief Get the status of a request
+	//! \brief Get the status of a completed request
 	//!
-	//! \param position The position of the request in the array
+	//! \param position The position of the status in the array
 	//!
 	//! \return The status
 	const status_t &getStatus(int position) const
@@ -110,9 +149,9 @@ public:
 		return _statuses[position];
 	}
 
-	//! \brief Get the status of a request
+	//! \brief Get the status of a completed request
 	//!
-	//! \param position The position of the request in the array
+	//! \param position The position of the status in the array
 	//!
 	//! \return The status
 	status_t &getStatus(int position)
@@ -148,8 +187,7 @@ public:
 	//! \return The ticket associated to the request
 	const Ticket &getAssociatedTicket(int position) const
 	{
-		assert(_mappings[position].ticket != nullptr);
-		return *_mappings[position].ticket;
+		return _tickets[_slots[position]];
 	}
 
 	//! \brief Get the ticket associated to a request
@@ -159,8 +197,7 @@ public:
 	//! \return The ticket associated to the request
 	Ticket &getAssociatedTicket(int position)
 	{
-		assert(_mappings[position].ticket != nullptr);
-		return *_mappings[position].ticket;
+		return _tickets[_slots[position]];
 	}
 
 	//! \brief Get the local position of the request in the ticket
@@ -170,11 +207,52 @@ public:
 	//! \return The local position of the request in the ticket
 	int getLocalPositionInTicket(int position) const
 	{
-		assert(_mappings[position].localPosition >= 0);
-		return _mappings[position].localPosition;
+		assert(_localPositions[_slots[position]] >= 0);
+		return _localPositions[_slots[position]];
+	}
+
+	//! \brief Get the poll epoch when the request was inserted
+	//!
+	//! \param position The position of the request in the array
+	//!
+	//! \return The insertion epoch of the request
+	uint64_t getEpoch(int position) const
+	{
+		return _epochs[_slots[position]];
+	}
+
+	//! \brief Set the poll epoch when the request was inserted
+	//!
+	//! \param position The position of the request in the array
+	//! \param epoch The insertion epoch of the request
+	void setEpoch(int position, uint64_t epoch)
+	{
+		_epochs[_slots[position]] = epoch;
+	}
+
+	//! \brief Get the flow control information of a request
+	//!
+	//! \param position The position of the request in the array
+	//!
+	//! \return The flow control information
+	const Flow &getFlow(int position) const
+	{
+		return _flows[_slots[position]];
 	}
 
-	//! \brief Allocate a ticket in the array
+	//! \brief Set the flow control information of a request
+	//!
+	//! \param position The position of the request in the array
+	//! \param flow The flow control information
+	void setFlow(int position, const Flow &flow)
+	{
+		_flows[_slots[position]] = flow;
+	}
+
+	//! \brief Allocate a slot and a ticket for a position
+	//!
+	//! This function must be called before associating the request of the
+	//! position. The slot is kept until the request is released
 	//!
 	//! \param position The position in the array to allocate the ticket
 	//! \param ticketArgs The arguments to in-place construct the ticket
@@ -183,37 +261,89 @@ public:
 	template <typename... Args>
 	Ticket &allocateTicket(int position, Args &&... ticketArgs)
 	{
-		new (&_tickets[position]) Ticket(std::forward<Args>(ticketArgs)...);
-		return _tickets[position];
+		assert(_nfree > 0);
+		int slot = _freeSlots[--_nfree];
+		_slots[position] = slot;
+
+		new (&_tickets[slot]) Ticket(std::forward<Args>(ticketArgs)...);
+		return _tickets[slot];
 	}
 
-	//! \brief Store and associate a request and a ticket
+	//! \brief Store a request and associate it to the ticket of its slot
+	//!
+	//! The ticket must have been allocated for the same position
 	//!
 	//! \param position The position to store the request
 	//! \param request The request
-	//! \param ticket The ticket
 	//! \param localPosition The local position of the request in the ticket
-	void associateRequest(int position, request_t &request, Ticket &ticket, int localPosition = 0)
+	void associateRequest(int position, request_t &request, int localPosition = 0)
 	{
 		_requests[position] = request;
-		_mappings[position].ticket = &ticket;
-		_mappings[position].localPosition = localPosition;
+		_localPositions[_slots[position]] = localPosition;
+	}
+
+	//! \brief Release the slot of a request
+	//!
+	//! The position must be overwritten or discarded afterwards
+	//!
+	//! \param position The position of the request
+	void releaseRequest(int position)
+	{
+		assert(_nfree < _capacity);
+		_freeSlots[_nfree++] = _slots[position];
 	}
 
 	//! \brief Move a request
 	//!
+	//! Only the request and its slot index are moved; the ticket and the
+	//! rest of metadata stay in the slot
+	//!
 	//! \param source The initial position of the request
 	//! \param destination The new position of the request
 	void moveRequest(int source, int destination)
 	{
 		assert(source != destination);
 		_requests[destination] = _requests[source];
-		_mappings[destination] = _mappings[source];
+		_slots[destination] = _slots[source];
+	}
 
-		if (_mappings[source].ticket == &_tickets[source]) {
-			_tickets[destination] = _tickets[source];
-			_mappings[destination].ticket = &_tickets[destination];
-		}
+private:
+	//! \brief Grow the arrays to store a number of requests
+	//!
+	//! The capacity grows at least by half to amortize the reallocations,
+	//! and it is rounded up to the chunk size
+	//!
+	//! \param count The number of requests
+	void grow(size_t count)
+	{
+		size_t capacity = std::max(count, _capacity + _capacity / 2);
+		capacity = ((capacity + ChunkSize - 1) / ChunkSize) * ChunkSize;
+
+		_requests  = reallocate(_requests, capacity);
+		_slots     = reallocate(_slots, capacity);
+		_statuses  = reallocate(_statuses, capacity);
+		_indices   = reallocate(_indices, capacity);
+		_tickets   = reallocate(_tickets, capacity);
+		_localPositions = reallocate(_localPositions, capacity);
+		_epochs    = reallocate(_epochs, capacity);
+		_flows     = reallocate(_flows, capacity);
+		_freeSlots = reallocate(_freeSlots, capacity);
+
+		// Add the new slots in descending order so the lowest are used first
+		for (size_t s = capacity; s > _capacity; --s)
+			_freeSlots[_nfree++] = (int) (s - 1);
+
+		_capacity = capacity;
+	}
+
+	//! \brief Reallocate an array
+	template <typename T>
+	static T *reallocate(T *array, size_t capacity)
+	{
+		T *result = (T *) std::realloc((void *) array, capacity * sizeof(T));
+		if (result == nullptr)
+			ErrorHandler::fail("Failed to allocate the request arrays");
+		return result;
 	}
 };
 
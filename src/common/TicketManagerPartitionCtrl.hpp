@@ -0,0 +1,357 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef TICKET_MANAGER_PARTITION_CTRL_HPP
+#define TICKET_MANAGER_PARTITION_CTRL_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Interface.hpp"
+#include "TaskContext.hpp"
+#include "util/ErrorHandler.hpp"
+#include "util/SpinLock.hpp"
+
+namespace tampi {
+
+//! Class that controls the partitioned requests started through the ticket
+//! manager. A partitioned request stays active until all its partitions are
+//! transferred, and the tasks bind their events either to the arrival of a
+//! specific partition or to the completion of the current round. The polling
+//! task checks the partition arrivals and the completion of the rounds along
+//! with the general arrays of requests. The active requests are indexed by
+//! their handle and the lock of the controller only protects the index, so
+//! the MPI calls marking or checking partitions are done outside the lock.
+//! Only the polling task tests the requests, so a request is never tested
+//! concurrently. A request started or freed before the polling task observed
+//! the completion of its previous round is restarted or freed by the polling
+//! task once that round completes
+template <typename Lang>
+class TicketManagerPartitionCtrl {
+private:
+	typedef typename Types<Lang>::request_t request_t;
+
+	//! The partition of the waiters for the completion of the round
+	static constexpr int Round = -1;
+
+	//! A task waiting for a partitioned request
+	struct Waiter {
+		//! The partition or Round
+		int partition;
+
+		//! The context of the waiting task
+		TaskContext context;
+	};
+
+	//! The state of an active partitioned request
+	struct Active {
+		//! The tasks waiting for the request
+		std::vector<Waiter> waiters;
+
+		//! The number of waiters for partition arrivals
+		size_t arrivals;
+
+		//! Whether a task started the request again
+		bool restart;
+
+		//! The context of the task that started the request again
+		TaskContext restartContext;
+
+		//! Whether a task freed the request
+		bool release;
+
+		Active() : waiters(), arrivals(0), restart(false), restartContext(), release(false)
+		{
+		}
+	};
+
+	//! The active partitioned requests
+	std::unordered_map<request_t, Active> _active;
+
+	//! The number of active requests, readable without the lock
+	std::atomic<size_t> _nactive;
+
+	//! The lock protecting the active requests
+	SpinLock _mutex;
+
+	//! The active requests being checked; only used by the polling task
+	std::vector<request_t> _checked;
+
+	//! The waiters being checked; only used by the polling task
+	std::vector<Waiter> _checkedWaiters;
+
+public:
+	TicketManagerPartitionCtrl() :
+		_active(), _nactive(0), _mutex(), _checked(), _checkedWaiters()
+	{
+	}
+
+	//! \brief Start a partitioned request
+	//!
+	//! The previous round of the request may not be observed as completed
+	//! yet, e.g., when its last partitions just arrived. In that case, the
+	//! start is left to the polling task and the events of the calling task
+	//! are bound to it, so the tasks depending on the start do not use the
+	//! request before it is started
+	//!
+	//! \param request The partitioned request
+	//! \param context The context of the calling task
+	void start(request_t request, TaskContext context)
+	{
+		std::lock_guard<SpinLock> guard(_mutex);
+
+		auto it = _active.find(request);
+		if (it != _active.end()) {
+			if (it->second.restart || it->second.release)
+				ErrorHandler::fail("Partitioned request started twice or after being freed");
+
+			context.bindEvents(1);
+			it->second.restart = true;
+			it->second.restartContext = context;
+			return;
+		}
+
+		issueStart(request);
+	}
+
+	//! \brief Free a partitioned request
+	//!
+	//! The last partitions of a receive request may be observed before the
+	//! completion of its round. In that case, the request is freed by the
+	//! polling task once the round completes, so it is never tested after
+	//! being freed
+	//!
+	//! \param request The partitioned request; set to the null request
+	void free(request_t &request)
+	{
+		{
+			std::lock_guard<SpinLock> guard(_mutex);
+
+			auto it = _active.find(request);
+			if (it != _active.end()) {
+				it->second.release = true;
+				request = Interface<Lang>::REQUEST_NULL;
+				return;
+			}
+		}
+
+		Interface<Lang>::requestFree(request);
+	}
+
+	//! \brief Mark a partition as ready and bind the calling task
+	//!
+	//! The events of the calling task are bound to the completion of the
+	//! round, after which the partition can be reused
+	//!
+	//! \param request The partitioned send request
+	//! \param partition The partition
+	//! \param context The context of the calling task
+	void ready(request_t request, int partition, TaskContext context)
+	{
+		{
+			std::lock_guard<SpinLock> guard(_mutex);
+
+			// Bind the events before the round can complete. Otherwise, the
+			// request is not active and MPI reports the error
+			auto it = _active.find(request);
+			if (it != _active.end()) {
+				context.bindEvents(1);
+				it->second.waiters.push_back(Waiter{ Round, context });
+			}
+		}
+
+		// The round cannot complete before marking this partition
+		int err = Interface<Lang>::mpi_pready(partition, request);
+		if (err != MPI_SUCCESS)
+			ErrorHandler::fail("Unexpected return code from MPI_Pready");
+	}
+
+	//! \brief Bind the calling task to the arrival of a partition
+	//!
+	//! \param request The partitioned receive request
+	//! \param partition The partition
+	//! \param context The context of the calling task
+	//!
+	//! \returns Whether the events were bound because the partition
+	//!          did not arrive yet
+	bool arrived(request_t request, int partition, TaskContext context)
+	{
+		if (_nactive.load(std::memory_order_acquire) == 0)
+			return false;
+
+		if (Interface<Lang>::parrived(request, partition))
+			return false;
+
+		std::lock_guard<SpinLock> guard(_mutex);
+
+		// The whole round already completed. Otherwise, the polling task
+		// checks the arrival of the partition
+		auto it = _active.find(request);
+		if (it == _active.end())
+			return false;
+
+		context.bindEvents(1);
+		it->second.waiters.push_back(Waiter{ partition, context });
+		++it->second.arrivals;
+
+		return true;
+	}
+
+	//! \brief Check the arrivals and the completion of the active requests
+	//!
+	//! This function is only called by the polling task. The arrivals of a
+	//! request are checked before its completion, so a request whose last
+	//! partition was observed is completed in the same check
+	//!
+	//! \param pending Add the number of active requests
+	//!
+	//! \returns The number of completed waiters
+	size_t check(size_t &pending)
+	{
+		if (_nactive.load(std::memory_order_acquire) == 0)
+			return 0;
+
+		{
+			std::lock_guard<SpinLock> guard(_mutex);
+
+			_checked.clear();
+			for (const auto &entry : _active)
+				_checked.push_back(entry.first);
+		}
+
+		size_t completed = 0;
+		for (request_t request : _checked) {
+			completed += checkArrivals(request);
+
+			if (Interface<Lang>::test(request, Interface<Lang>::STATUS_IGNORE))
+				completed += completeRound(request);
+		}
+
+		pending += _nactive.load(std::memory_order_relaxed);
+
+		return completed;
+	}
+
+private:
+	//! \brief Start a partitioned request and mark it as active
+	//!
+	//! This function assumes the lock is already acquired
+	//!
+	//! \param request The partitioned request
+	void issueStart(request_t request)
+	{
+		Interface<Lang>::start(request);
+
+		[[maybe_unused]] bool inserted = _active.try_emplace(request).second;
+		assert(inserted);
+
+		_nactive.store(_active.size(), std::memory_order_release);
+	}
+
+	//! \brief Complete the waiters whose partition arrived
+	//!
+	//! The waiters are taken out of the request while checking their
+	//! partitions without the lock, and the pending ones are put back
+	//!
+	//! \param request The active partitioned request
+	//!
+	//! \returns The number of completed waiters
+	size_t checkArrivals(request_t request)
+	{
+		_checkedWaiters.clear();
+		{
+			std::lock_guard<SpinLock> guard(_mutex);
+
+			auto it = _active.find(request);
+			assert(it != _active.end());
+
+			Active &active = it->second;
+			if (active.arrivals == 0)
+				return 0;
+
+			size_t remaining = 0;
+			for (const Waiter &waiter : active.waiters) {
+				if (waiter.partition != Round)
+					_checkedWaiters.push_back(waiter);
+				else
+					active.waiters[remaining++] = waiter;
+			}
+			active.waiters.resize(remaining);
+			active.arrivals = 0;
+		}
+
+		size_t completed = 0;
+		size_t remaining = 0;
+		for (const Waiter &waiter : _checkedWaiters) {
+			if (Interface<Lang>::parrived(request, waiter.partition)) {
+				TaskContext context = waiter.context;
+				context.completeEvents(1, true);
+				++completed;
+			} else {
+				_checkedWaiters[remaining++] = waiter;
+			}
+		}
+
+		if (remaining > 0) {
+			std::lock_guard<SpinLock> guard(_mutex);
+
+			Active &active = _active.find(request)->second;
+			active.waiters.insert(active.waiters.end(), _checkedWaiters.begin(), _checkedWaiters.begin() + remaining);
+			active.arrivals += remaining;
+		}
+
+		return completed;
+	}
+
+	//! \brief Complete the round of an active request
+	//!
+	//! The request is removed from the active requests and all its waiters
+	//! are completed. Then, the request is started again or freed if a task
+	//! already requested it
+	//!
+	//! \param request The partitioned request
+	//!
+	//! \returns The number of completed waiters
+	size_t completeRound(request_t request)
+	{
+		Active active;
+		{
+			std::lock_guard<SpinLock> guard(_mutex);
+
+			auto it = _active.find(request);
+			assert(it != _active.end());
+
+			active = std::move(it->second);
+			_active.erase(it);
+			_nactive.store(_active.size(), std::memory_order_release);
+
+			if (active.restart)
+				issueStart(request);
+		}
+
+		if (active.release)
+			Interface<Lang>::requestFree(request);
+
+		for (Waiter &waiter : active.waiters)
+			waiter.context.completeEvents(1, true);
+
+		size_t completed = active.waiters.size();
+		if (active.restart) {
+			active.restartContext.completeEvents(1, true);
+			++completed;
+		}
+		return completed;
+	}
+};
+
+} // namespace tampi
+
+#endif // TICKET_MANAGER_PARTITION_CTRL_HPP
@@ -0,0 +1,223 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef TICKET_MANAGER_TESTING_CTRL_HPP
+#define TICKET_MANAGER_TESTING_CTRL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "util/Clock.hpp"
+#include "util/EnvironmentVariable.hpp"
+#include "util/ErrorHandler.hpp"
+
+namespace tampi {
+
+//! The approaches for request testing
+enum class TestingApproach {
+	Test = 0,
+	TestSome,
+	TestAny,
+	None,
+	Auto
+};
+
+//! Class that controls how the MPI requests are tested. The approaches can be
+//! fixed by the user or chosen dynamically. In the automatic mode, the general
+//! testing uses MPI_Test when there are few requests and otherwise picks the
+//! approach with the lowest measured cost per request, exploring the other
+//! approaches periodically. The immediate testing is disabled while its hit
+//! rate is negligible and it is probed again periodically
+class TicketManagerTestingCtrl {
+private:
+	//! The approaches that the automatic mode chooses from
+	static constexpr int NumCandidates = 3;
+
+	//! Maximum number of requests to test with MPI_Test directly
+	static constexpr int SmallCount = 4;
+
+	//! Number of decisions between explorations of other approaches
+	static constexpr uint64_t ExplorePeriod = 64;
+
+	//! Number of disabled immediate testings between probes
+	static constexpr uint64_t ProbePeriod = 128;
+
+	//! The minimum hit rate to keep the immediate testing enabled
+	static constexpr double MinHitRate = 0.01;
+
+	//! The weight of the last sample in the moving averages
+	static constexpr double Alpha = 0.125;
+
+	//! The approach for the general testing
+	TestingApproach _general;
+
+	//! The approach for the immediate testing
+	TestingApproach _immediate;
+
+	//! The moving average of the cost (in ns) per tested request
+	double _cost[NumCandidates];
+
+	//! The best approach for the general testing in the automatic mode
+	TestingApproach _best;
+
+	//! The number of decisions of the general testing
+	uint64_t _decisions;
+
+	//! The next approach to explore
+	int _explore;
+
+	//! The moving average of the immediate testing hit rate
+	double _hitRate;
+
+	//! Whether the immediate testing is enabled in the automatic mode
+	bool _immediateEnabled;
+
+	//! The number of immediate testings skipped since the last probe
+	uint64_t _skipped;
+
+public:
+	TicketManagerTestingCtrl() :
+		_general(parseTestingOption("TAMPI_REQUESTS_TESTING", TestingApproach::TestSome)),
+		_immediate(parseTestingOption("TAMPI_REQUESTS_IMMEDIATE_TESTING", _general)),
+		_cost(),
+		_best(TestingApproach::TestSome),
+		_decisions(0),
+		_explore(0),
+		_hitRate(1.0),
+		_immediateEnabled(true),
+		_skipped(0)
+	{
+		if (_general == TestingApproach::None)
+			ErrorHandler::fail("Invalid approach for general request testing");
+	}
+
+	//! \brief Choose the approach to test a batch of in-flight requests
+	//!
+	//! \param count The number of requests to test
+	inline TestingApproach chooseGeneral(int count)
+	{
+		if (_general != TestingApproach::Auto)
+			return _general;
+
+		return choose(count);
+	}
+
+	//! \brief Begin measuring a general testing
+	//!
+	//! \returns The current timestamp or zero if not measuring
+	inline uint64_t beginGeneral() const
+	{
+		return (_general == TestingApproach::Auto) ? Clock::now_ns() : 0;
+	}
+
+	//! \brief Evaluate the cost of a general testing
+	//!
+	//! \param approach The approach used
+	//! \param count The number of requests tested
+	//! \param begin The timestamp returned by beginGeneral
+	inline void endGeneral(TestingApproach approach, int count, uint64_t begin)
+	{
+		if (_general != TestingApproach::Auto || count <= SmallCount)
+			return;
+
+		double cost = (double) (Clock::now_ns() - begin) / count;
+		double &average = _cost[(int) approach];
+		average = (average == 0.0) ? cost : average + Alpha * (cost - average);
+
+		// Update the best known approach
+		int best = (int) _best;
+		for (int c = 0; c < NumCandidates; ++c) {
+			if (_cost[c] > 0.0 && (_cost[best] == 0.0 || _cost[c] < _cost[best]))
+				best = c;
+		}
+		_best = (TestingApproach) best;
+	}
+
+	//! \brief Choose the approach to test requests right after issuing them
+	//!
+	//! \param count The number of requests to test
+	inline TestingApproach chooseImmediate(int count)
+	{
+		if (_immediate != TestingApproach::Auto)
+			return _immediate;
+
+		// Probe the immediate testing periodically when disabled
+		if (!_immediateEnabled && ++_skipped < ProbePeriod)
+			return TestingApproach::None;
+
+		_skipped = 0;
+		return choose(count);
+	}
+
+	//! \brief Evaluate the yield of an immediate testing
+	//!
+	//! \param approach The approach used
+	//! \param count The number of requests tested
+	//! \param completed The number of requests completed
+	inline void evaluateImmediate(TestingApproach approach, int count, int completed)
+	{
+		if (_immediate != TestingApproach::Auto || approach == TestingApproach::None || count == 0)
+			return;
+
+		double rate = (double) completed / count;
+		_hitRate += Alpha * (rate - _hitRate);
+
+		if (completed > 0) {
+			// Re-enable it as soon as a probe hits
+			_hitRate = std::max(_hitRate, MinHitRate);
+			_immediateEnabled = true;
+		} else {
+			_immediateEnabled = (_hitRate >= MinHitRate);
+		}
+	}
+
+private:
+	//! \brief Choose an approach in the automatic mode
+	//!
+	//! \param count The number of requests to test
+	inline TestingApproach choose(int count)
+	{
+		if (count <= SmallCount)
+			return TestingApproach::Test;
+
+		// Explore the approaches periodically to refresh their costs
+		if (++_decisions % ExplorePeriod == 0) {
+			_explore = (_explore + 1) % NumCandidates;
+			return (TestingApproach) _explore;
+		}
+		return _best;
+	}
+
+	//! \brief Parse request testing option
+	static TestingApproach parseTestingOption(
+		const std::string &name, TestingApproach defaultValue
+	) {
+		EnvironmentVariable<std::string> value(name);
+
+		if (!value.isPresent())
+			return defaultValue;
+
+		if (value.get() == "testsome")
+			return TestingApproach::TestSome;
+		if (value.get() == "testany")
+			return TestingApproach::TestAny;
+		if (value.get() == "test")
+			return TestingApproach::Test;
+		if (value.get() == "none")
+			return TestingApproach::None;
+		if (value.get() == "auto")
+			return TestingApproach::Auto;
+
+		ErrorHandler::fail(name, " has invalid value");
+
+		return TestingApproach::None;
+	}
+};
+
+} // namespace tampi
+
+#endif // TICKET_MANAGER_TESTING_CTRL_HPP
@@ -0,0 +1,125 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef TICKET_MANAGER_TIERING_CTRL_HPP
+#define TICKET_MANAGER_TIERING_CTRL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "util/EnvironmentVariable.hpp"
+#include "util/ErrorHandler.hpp"
+#include "util/StringSupport.hpp"
+
+namespace tampi {
+
+//! Class that controls how the in-flight requests are distributed between the
+//! hot and cold tiers of the ticket manager. Fresh point-to-point requests are
+//! placed in the hot tier, which is tested on every poll. Requests that remain
+//! in the hot tier for a certain number of polls are demoted to the cold tier,
+//! which also receives the collective requests. The cold tier is tested with a
+//! decaying frequency: its period doubles after each unfruitful test and it is
+//! reset once a test completes any request
+class TicketManagerTieringCtrl {
+private:
+	//! The default maximum period (in polls) of the cold tier
+	static constexpr uint64_t DefaultMaxPeriod = 64;
+
+	//! Indicate whether the tiering is enabled
+	bool _enabled;
+
+	//! The number of polls after which a hot request is demoted
+	uint64_t _demotionAge;
+
+	//! The maximum period (in polls) between tests of the cold tier
+	uint64_t _maxPeriod;
+
+	//! The current period (in polls) between tests of the cold tier
+	uint64_t _period;
+
+	//! The number of polls until the next test of the cold tier
+	uint64_t _countdown;
+
+	//! The current poll epoch
+	uint64_t _epoch;
+
+public:
+	TicketManagerTieringCtrl() :
+		_enabled(false),
+		_demotionAge(0),
+		_maxPeriod(DefaultMaxPeriod),
+		_period(1),
+		_countdown(0),
+		_epoch(0)
+	{
+		EnvironmentVariable<std::string> policy("TAMPI_REQUESTS_TIERING");
+		if (!policy.isPresent())
+			return;
+
+		bool present[2];
+		if (!StringSupport::parse(policy.get(), present, _demotionAge, _maxPeriod, ':'))
+			ErrorHandler::fail("TAMPI_REQUESTS_TIERING has format '<demotion age>[:<max period>]'");
+
+		if (!present[1])
+			_maxPeriod = DefaultMaxPeriod;
+		if (_maxPeriod == 0)
+			ErrorHandler::fail("TAMPI_REQUESTS_TIERING cannot have a zero max period");
+
+		_enabled = (_demotionAge > 0);
+	}
+
+	//! \brief Indicate whether the tiering is enabled
+	inline bool isEnabled() const
+	{
+		return _enabled;
+	}
+
+	//! \brief Get the current poll epoch
+	inline uint64_t getEpoch() const
+	{
+		return _epoch;
+	}
+
+	//! \brief Indicate whether a hot request must be demoted
+	//!
+	//! \param epoch The poll epoch when the request was inserted
+	inline bool mustDemote(uint64_t epoch) const
+	{
+		return (_epoch - epoch >= _demotionAge);
+	}
+
+	//! \brief Indicate whether the cold tier should be tested in this poll
+	inline bool mustCheckCold() const
+	{
+		return (_countdown == 0);
+	}
+
+	//! \brief Evaluate the result of testing the cold tier
+	//!
+	//! \param completed The number of completed cold requests
+	inline void evaluateCold(uint64_t completed)
+	{
+		if (completed > 0)
+			_period = 1;
+		else
+			_period = std::min(_period * 2, _maxPeriod);
+
+		_countdown = _period;
+	}
+
+	//! \brief Advance to the next poll epoch
+	inline void advance()
+	{
+		if (_countdown > 0)
+			--_countdown;
+		++_epoch;
+	}
+};
+
+} // namespace tampi
+
+#endif // TICKET_MANAGER_TIERING_CTRL_HPP
@@ -1,15 +1,18 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2025 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef POLLING_HPP
 #define POLLING_HPP
 
 #include <cstdint>
+#include <string>
+#include <vector>
 
 #include "PollingPeriodCtrl.hpp"
+#include "Sharding.hpp"
 #include "TaskingModel.hpp"
 #include "TicketManager.hpp"
 #include "instrument/Instrument.hpp"
@@ -19,12 +22,12 @@ namespace tampi {
 //! Class that represents the polling features
 class Polling {
 private:
-	//! The polling instance of the task that periodically checks the in-flight
-	//! MPI requests
-	static TaskingModel::PollingInstance *_pollingInstance;
+	//! The polling instances of the tasks that periodically check the in-flight
+	//! MPI requests; one per shard
+	static std::vector<TaskingModel::PollingInstance *> _pollingInstances;
 
-	//! The controller of the polling period
-	static PollingPeriodCtrl _periodCtrl;
+	//! The controllers of the polling period; one per shard
+	static std::vector<PollingPeriodCtrl *> _periodCtrls;
 
 	//! The polling instance of the task that processes completions
 	static TaskingModel::PollingInstance *_completionPollingInstance;
@@ -40,20 +43,68 @@ public:
 	//! \brief Initialize the polling features
 	static void initialize()
 	{
-		_pollingInstance = TaskingModel::registerPolling("TAMPI", Polling::polling, nullptr);
+		size_t nshards = Sharding::getNumShards();
 
 		if (CompletionManager::isEnabled())
-			_completionPollingInstance = TaskingModel::registerPolling(
+			CompletionManager::initialize(nshards);
+
+		// Create the completion polling instance first since the polling
+		// tasks may notify it as soon as they start
+		if (CompletionManager::isEnabled()) {
+			_completionPollingInstance = TaskingModel::createPolling(
 					"TAMPI Comp", Polling::completions, nullptr);
+			CompletionManager::setPollingInstance(_completionPollingInstance);
+		}
+
+		for (size_t s = 0; s < nshards; ++s) {
+			std::string name = (nshards == 1) ? "TAMPI" : "TAMPI " + std::to_string(s);
+
+			TaskingModel::PollingInstance *instance = TaskingModel::createPolling(
+					name, Polling::polling, reinterpret_cast<void *>(s));
+
+			// Publish the instance to the ticket managers before starting it
+#ifndef DISABLE_C_LANG
+			TicketManager<C>::get(s).setPollingInstance(instance);
+#endif
+#ifndef DISABLE_FORTRAN_LANG
+			TicketManager<Fortran>::get(s).setPollingInstance(instance);
+#endif
+			_periodCtrls.push_back(new PollingPeriodCtrl("TAMPI_POLLING_PERIOD"));
+			_pollingInstances.push_back(instance);
+		}
+
+		for (TaskingModel::PollingInstance *instance : _pollingInstances)
+			TaskingModel::startPolling(instance);
+
+		if (CompletionManager::isEnabled())
+			TaskingModel::startPolling(_completionPollingInstance);
 	}
 
 	//! \brief Finalize the polling features
 	static void finalize()
 	{
-		TaskingModel::unregisterPolling(_pollingInstance);
+		for (size_t s = 0; s < _pollingInstances.size(); ++s) {
+			TaskingModel::unregisterPolling(_pollingInstances[s]);
 
-		if (CompletionManager::isEnabled())
+#ifndef DISABLE_C_LANG
+			TicketManager<C>::get(s).setPollingInstance(nullptr);
+#endif
+#ifndef DISABLE_FORTRAN_LANG
+			TicketManager<Fortran>::get(s).setPollingInstance(nullptr);
+#endif
+		}
+
+		for (PollingPeriodCtrl *periodCtrl : _periodCtrls)
+			delete periodCtrl;
+
+		_pollingInstances.clear();
+		_periodCtrls.clear();
+
+		if (CompletionManager::isEnabled()) {
 			TaskingModel::unregisterPolling(_completionPollingInstance);
+			CompletionManager::setPollingInstance(nullptr);
+			CompletionManager::finalize();
+		}
 	}
 
 private:
@@ -61,27 +112,38 @@ private:
 	//!
 	//! This function is periodically called by the tasking runtime system
 	//! and should check for the in-flight MPI requests posted from both C
-	//! and Fortran languages (if needed)
+	//! and Fortran languages (if needed) of a shard
 	//!
-	//! \param args An opaque pointer to the arguments
+	//! \param args The shard index
 	//!
 	//! \returns How many microseconds should the task wait in the next call
-	static uint64_t polling(void *)
+	static uint64_t polling(void *args)
 	{
+		size_t shard = reinterpret_cast<size_t>(args);
 		size_t pending = 0;
 		size_t completed = 0;
 
 		Instrument::Guard<LibraryPolling> instrGuard;
 
 #ifndef DISABLE_C_LANG
-		TicketManager<C> &cManager = TicketManager<C>::get();
+		TicketManager<C> &cManager = TicketManager<C>::get(shard);
 		completed += cManager.checkRequests(pending);
 #endif
 #ifndef DISABLE_FORTRAN_LANG
-		TicketManager<Fortran> &fortranManager = TicketManager<Fortran>::get();
+		TicketManager<Fortran> &fortranManager = TicketManager<Fortran>::get(shard);
 		completed += fortranManager.checkRequests(pending);
 #endif
-		return _periodCtrl.getPeriod(completed, pending);
+		// The overflowed completions are pending as well
+		if (CompletionManager::isEnabled())
+			pending += CompletionManager::flush(shard);
+
+		uint64_t period = _periodCtrls[shard]->getPeriod(completed, pending);
+
+		// Park the polling task while there is no work
+		if (pending == 0 && completed == 0 && TaskingModel::isIdleParkingEnabled())
+			return TaskingModel::IdlePeriod;
+
+		return period;
 	}
 
 	//! \brief Polling function that checks the completions
@@ -97,7 +159,13 @@ private:
 	{
 		size_t completed = CompletionManager::process();
 
-		return _completionPeriodCtrl.getPeriod(completed, 0);
+		uint64_t period = _completionPeriodCtrl.getPeriod(completed, 0);
+
+		// Park the completion task while there is no work
+		if (completed == 0 && TaskingModel::isIdleParkingEnabled())
+			return TaskingModel::IdlePeriod;
+
+		return period;
 	}
 };
 
@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef BOOST_LOCK_FREE_QUEUE_HPP
@@ -16,6 +16,7 @@
 
 #include <boost/lockfree/spsc_queue.hpp>
 
+#include "Backpressure.hpp"
 #include "EnvironmentVariable.hpp"
 #include "ErrorHandler.hpp"
 #include "SpinLock.hpp"
@@ -43,12 +44,16 @@ private:
 	//! Single producer single consumer queue
 	alignas(CacheAlignment) queue_t _queue;
 
+	//! The backpressure applied to the producers when the queue is full
+	alignas(CacheAlignment) Backpressure _backpressure;
+
 public:
 	BoostLockFreeQueue(bool multipleProducers = true) :
 		_multipleProducers(multipleProducers),
 		_fullFailure("TAMPI_QUEUES_FULL_FAILURE", false),
 		_adderMutex(),
-		_queue()
+		_queue(),
+		_backpressure()
 	{
 	}
 
@@ -57,6 +62,11 @@ public:
 	//! \param element The element to add
 	void push(const T &element)
 	{
+		if (!_fullFailure && Backpressure::isEnabled()) {
+			pushBackpressure(&element, 1);
+			return;
+		}
+
 		// Acquire the producer mutex if needed
 		if (_multipleProducers)
 			_adderMutex.lock();
@@ -77,6 +87,11 @@ public:
 	//! \param count The number of elements to add
 	void push(const T elements[], size_t count)
 	{
+		if (!_fullFailure && Backpressure::isEnabled()) {
+			pushBackpressure(elements, count);
+			return;
+		}
+
 		// Acquire the producer mutex if needed
 		if (_multipleProducers)
 			_adderMutex.lock();
@@ -91,6 +106,14 @@ public:
 			_adderMutex.unlock();
 	}
 
+	//! \brief Check whether the queue is empty
+	//!
+	//! This function must be called by the consumer side
+	bool empty()
+	{
+		return (_queue.read_available() == 0);
+	}
+
 	//! \brief Pop multiple elements from the queue
 	//!
 	//! \param elements The array to store the retrieved elements
@@ -100,7 +123,12 @@ public:
 	size_t pop(T elements[], size_t count)
 	{
 		assert(elements != nullptr);
-		return _queue.pop(elements, count);
+
+		size_t popped = _queue.pop(elements, count);
+		if (popped > 0 && Backpressure::isEnabled())
+			_backpressure.release();
+
+		return popped;
 	}
 
 private:
@@ -114,6 +142,29 @@ private:
 			ErrorHandler::fail("BoostLockFreeQueue is full");
 	}
 
+	//! \brief Push elements to the queue or block the task while full
+	//!
+	//! The producer mutex is not held while the task is blocked, so other
+	//! producers can push in the meantime
+	//!
+	//! \param elements The elements to add
+	//! \param count The number of elements to add
+	void pushBackpressure(const T elements[], size_t count)
+	{
+		size_t pushed = 0;
+		_backpressure.waitUntil([&]() {
+			if (_multipleProducers)
+				_adderMutex.lock();
+
+			pushed += _queue.push(&elements[pushed], count - pushed);
+
+			if (_multipleProducers)
+				_adderMutex.unlock();
+
+			return (pushed == count);
+		});
+	}
+
 	//! \brief Push elements to the queue unconditionally
 	//!
 	//! \param elements The elements to add
@@ -1,12 +1,13 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef CLOCK_HPP
 #define CLOCK_HPP
 
+#include <cstdint>
 #include <time.h>
 
 #ifdef CLOCK_MONOTONIC_COARSE
@@ -26,6 +27,13 @@ public:
 		clock_gettime(CLK_SRC_FAST, &tp);
 		return (double)(tp.tv_sec) * 1.0e3 + (double)(tp.tv_nsec) * 1.0e-6;
 	}
+
+	static inline uint64_t now_ns()
+	{
+		struct timespec tp;
+		clock_gettime(CLOCK_MONOTONIC, &tp);
+		return (uint64_t)(tp.tv_sec) * 1000000000ULL + (uint64_t)(tp.tv_nsec);
+	}
 };
 
 } // namespace tampi
@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2019-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2019-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef ERROR_HANDLER_HPP
@@ -133,6 +133,23 @@ public:
 		}
 	}
 
+	//! \brief Print an informative message
+	//!
+	//! \param reasonParts The parts of the message
+	template <typename... TS>
+	static void info(TS... reasonParts)
+	{
+		std::ostringstream oss;
+		oss << "Info: ";
+		emitReasonParts(oss, reasonParts...);
+		oss << std::endl;
+
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			std::cerr << oss.str();
+		}
+	}
+
 	//! \brief Print a warning message if failed
 	//!
 	//! \param failure Whether the condition failed
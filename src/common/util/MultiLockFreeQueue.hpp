@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2023-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef MULTI_LOCK_FREE_QUEUE_HPP
@@ -14,8 +14,9 @@
 #include <cstdlib>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
-#include "EnvironmentVariable.hpp"
+#include "ErrorHandler.hpp"
 #include "Utils.hpp"
 
 
@@ -30,111 +31,278 @@ enum class MultiQueuePopPolicy {
 	//! the same queue to achieve the most optimal copy possible.
 	//! The policy does not focus on fairness but performance
 	BlockRoundRobin,
+	//! Oldest-first pop operation that removes the elements in
+	//! their approximate global arrival order according to the
+	//! epoch when they were pushed. The policy focuses on bounding
+	//! the time that elements wait in the queues
+	OldestFirst,
 };
 
-template <typename T, MultiQueuePopPolicy Policy, size_t Capacity = 32*1024, size_t MaxQueues = MaxSystemCPUs>
+//! Class that provides a multi-producer single-consumer queue composed of
+//! one single-producer queue per CPU. Each per-CPU queue is a linked list of
+//! fixed-size segments that are allocated on demand when the queue grows and
+//! recycled by the consumer through a small per-queue free list, so the memory
+//! footprint follows the actual burst depth and pushing never fails due to a
+//! full queue. The segments are taken from the heap unless the memory is bound
+//! to NUMA nodes. The producers
+//! maintain a two-level bitmap of the non-empty queues, so the consumer only
+//! inspects the queues that may have elements. The first level groups the
+//! queues of consecutive CPUs, which usually belong to the same NUMA domain.
+//! The number of queues is the number of CPUs at run-time. The pop policy is
+//! chosen when constructing the queue
+template <typename T, size_t SegmentSize = 256>
 class MultiLockFreeQueue {
 	typedef uint64_t counter_t;
 	typedef std::atomic<counter_t> atomic_counter_t;
-	typedef T* const __restrict__ data_ptr_t;
+	typedef uint64_t bitmap_t;
+	typedef std::atomic<bitmap_t> atomic_bitmap_t;
 
-	alignas(CacheAlignment) const size_t _capacity;
-	const size_t _queues;
-	data_ptr_t _data;
+	//! The number of bits per bitmap word
+	static constexpr size_t WordBits = sizeof(bitmap_t) * 8;
 
-	//! Envar indicating whether the execution should abort if the queue is full
-	const EnvironmentVariable<bool> _fullFailure;
+	//! Fixed-size segment of a per-CPU queue
+	struct alignas(CacheAlignment) Segment {
+		//! The elements of the segment
+		T data[SegmentSize];
 
-	alignas(CacheAlignment) PaddedArray<atomic_counter_t, MaxQueues> _tail;
+		//! The epochs when the elements were pushed; only used by the
+		//! oldest-first policy
+		uint64_t stamps[SegmentSize];
 
-	// The more packed the better
-	alignas(CacheAlignment) counter_t _remaining[MaxQueues];
+		//! The next segment of the queue
+		std::atomic<Segment *> next;
+
+		Segment() : next(nullptr)
+		{
+		}
+	};
+
+	//! The number of consumed segments kept per queue for reuse
+	static constexpr size_t MaxSpares = 4;
+
+	//! The free list of consumed segments of a per-CPU queue. Each slot is
+	//! filled by the consumer and emptied by the producer
+	struct Spares {
+		std::atomic<Segment *> slots[MaxSpares];
+	};
+
+	//! The state of a per-CPU queue owned by one of the sides
+	struct Lane {
+		//! The current segment
+		Segment *segment;
+
+		//! The position in the current segment
+		size_t position;
+
+		//! The number of elements pushed or popped
+		atomic_counter_t count;
+	};
+
+	alignas(CacheAlignment) const size_t _queues;
+
+	//! The number of words of the non-empty bitmap and its summary
+	const size_t _words;
+	const size_t _summaryWords;
+
+	//! The policy to pop elements
+	const MultiQueuePopPolicy _policy;
+
+	//! The current epoch, advanced by the consumer on each pop
+	alignas(CacheAlignment) atomic_counter_t _epoch;
+
+	//! The producer side of each queue
+	alignas(CacheAlignment) PaddedArray<Lane> _producers;
+
+	//! The consumer side of each queue
+	alignas(CacheAlignment) PaddedArray<Lane> _consumers;
+
+	//! The segments of each queue recycled by the consumer
+	alignas(CacheAlignment) PaddedArray<Spares> _spares;
+
+	//! The bitmap of queues that may be non-empty; one bit per queue
+	alignas(CacheAlignment) PaddedArray<atomic_bitmap_t> _nonEmpty;
 
-	alignas(CacheAlignment) PaddedArray<atomic_counter_t, MaxQueues> _head;
+	//! The summary of non-zero words of the bitmap; one bit per word
+	alignas(CacheAlignment) PaddedArray<atomic_bitmap_t> _summary;
 
-	// The elements of this array should be padded to avoid false sharing
-	alignas(CacheAlignment) PaddedArray<counter_t, MaxQueues> _available;
+	// The more packed the better
+	alignas(CacheAlignment) std::vector<counter_t> _remaining;
+
+	//! Auxiliary array of the consumer with one entry per queue
+	std::vector<size_t> _auxiliary;
 
 	alignas(CacheAlignment) size_t _totalRemaining;
 	size_t _current;
 
 public:
-	MultiLockFreeQueue() :
-		_capacity(Capacity),
+	MultiLockFreeQueue(MultiQueuePopPolicy policy = MultiQueuePopPolicy::CyclicRoundRobin) :
 		_queues(TaskingModel::getNumLogicalCPUs()),
-		_data(Memory::alignedAlloc<T>(_queues * _capacity)),
-		_fullFailure("TAMPI_QUEUES_FULL_FAILURE", true),
-		_tail(),
-		_head(),
-		_available(),
+		_words((_queues + WordBits - 1) / WordBits),
+		_summaryWords((_words + WordBits - 1) / WordBits),
+		_policy(policy),
+		_epoch(0),
+		_producers(_queues),
+		_consumers(_queues),
+		_spares(_queues),
+		_nonEmpty(_words),
+		_summary(_summaryWords),
+		_remaining(_queues, 0),
+		_auxiliary(_queues, 0),
 		_totalRemaining(0),
 		_current(0)
 	{
-		if (_queues > MaxQueues)
-			ErrorHandler::fail(__func__, ": Maximum number of queues exceeded. Runtime got: ", _queues, ", TAMPI was compiled with maximum: ", MaxQueues);
-
+		// The first segment of each queue is allocated on the first push
 		for (size_t i = 0; i < _queues; i++) {
-			_tail[i].store(0);
-			_head[i].store(0);
-			_available[i] = 0;
-			_remaining[i] = 0;
+			_producers[i].segment = nullptr;
+			_producers[i].position = 0;
+			_producers[i].count.store(0);
+			_consumers[i].segment = nullptr;
+			_consumers[i].position = 0;
+			_consumers[i].count.store(0);
+			for (size_t s = 0; s < MaxSpares; s++)
+				_spares[i].slots[s].store(nullptr);
 		}
+
+		for (size_t w = 0; w < _words; w++)
+			_nonEmpty[w].store(0);
+		for (size_t s = 0; s < _summaryWords; s++)
+			_summary[s].store(0);
 	}
 
 	~MultiLockFreeQueue()
 	{
-		Memory::alignedFree<T>(_data, _queues * _capacity);
+		for (size_t i = 0; i < _queues; i++) {
+			Segment *segment = _consumers[i].segment;
+			while (segment != nullptr) {
+				Segment *next = segment->next.load(std::memory_order_relaxed);
+				freeSegment(segment);
+				segment = next;
+			}
+			for (size_t s = 0; s < MaxSpares; s++)
+				freeSegment(_spares[i].slots[s].load(std::memory_order_relaxed));
+		}
 	}
 
 private:
 	size_t getRemaining(size_t queue) const
 	{
 		assert(queue < _queues);
-		size_t head = _head[queue].load(std::memory_order_acquire);
-		size_t tail = _tail[queue].load(std::memory_order_relaxed);
-		assert(head < _capacity);
-		assert(tail < _capacity);
-		return (tail <= head) ? head - tail : (head - tail) + _capacity;
+		counter_t pushed = _producers[queue].count.load(std::memory_order_acquire);
+		counter_t popped = _consumers[queue].count.load(std::memory_order_relaxed);
+		assert(pushed >= popped);
+		return pushed - popped;
 	}
 
+	//! \brief Update the remaining elements of the non-empty queues
+	//!
+	//! Only the queues marked in the bitmap are inspected. The queues found
+	//! empty are unmarked and checked again, so a concurrent push is either
+	//! seen here or marks the queue again
 	size_t updateRemaining()
 	{
 		size_t total = 0;
-		for (size_t q = 0; q < _queues; q++) {
-			size_t val = getRemaining(q);
-			_remaining[q] = val;
-			total += val;
+
+		for (size_t s = 0; s < _summaryWords; s++)
+			total += updateRemaining(s);
+		return total;
+	}
+
+	//! \brief Update the remaining elements of the queues of a summary word
+	size_t updateRemaining(size_t s)
+	{
+		size_t total = 0;
+
+		bitmap_t summary = _summary[s].load(std::memory_order_acquire);
+		while (summary) {
+			size_t sb = __builtin_ctzll(summary);
+			size_t w = s * WordBits + sb;
+			summary &= summary - 1;
+
+			bitmap_t word = _nonEmpty[w].load(std::memory_order_acquire);
+			while (word) {
+				size_t b = __builtin_ctzll(word);
+				word &= word - 1;
+
+				size_t q = w * WordBits + b;
+				size_t val = getRemaining(q);
+				if (val == 0) {
+					_nonEmpty[w].fetch_and(~((bitmap_t) 1 << b));
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+
+					val = getRemaining(q);
+					if (val > 0)
+						_nonEmpty[w].fetch_or((bitmap_t) 1 << b);
+				}
+				_remaining[q] = val;
+				total += val;
+			}
+
+			// Unmark the word if all its queues were empty
+			if (_nonEmpty[w].load(std::memory_order_relaxed) == 0) {
+				_summary[s].fetch_and(~((bitmap_t) 1 << sb));
+				if (_nonEmpty[w].load() != 0)
+					_summary[s].fetch_or((bitmap_t) 1 << sb);
+			}
 		}
 		return total;
 	}
 
-	size_t getAvailable(size_t queue) const
+	//! \brief Mark a queue as non-empty after pushing to it
+	void markNonEmpty(size_t queue)
 	{
-		assert(queue < _queues);
-		return _capacity - (getRemaining(queue) + 1);
+		const size_t w = queue / WordBits;
+		const bitmap_t bit = (bitmap_t) 1 << (queue % WordBits);
+
+		// Order the push with the check of the mark
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (_nonEmpty[w].load(std::memory_order_relaxed) & bit)
+			return;
+
+		bitmap_t previous = _nonEmpty[w].fetch_or(bit);
+		if (previous == 0)
+			_summary[w / WordBits].fetch_or((bitmap_t) 1 << (w % WordBits));
 	}
 
-	void unsafePush(size_t queue, T const __restrict__ elems[], size_t n)
+	//! \brief Push several elements into a queue
+	//!
+	//! The elements are published at once with a single update of the counter
+	void unsafePush(size_t queue, const T elements[], size_t n)
 	{
 		assert(queue < _queues);
-		assert(n > 0);
-		assert(n <= _available[queue]);
 
-		_available[queue] -= (counter_t) n;
-		data_ptr_t data = _data + (queue * _capacity);
+		Lane &lane = _producers[queue];
+
+		for (size_t e = 0; e < n; ++e) {
+			if (lane.segment == nullptr) {
+				// Allocate the first segment of the queue. The consumer reads
+				// it after observing the counter below
+				Segment *segment = allocateSegment();
+				lane.segment = segment;
+				lane.position = 0;
+				_consumers[queue].segment = segment;
+			} else if (lane.position == SegmentSize) {
+				// Link a new segment if the current one is full
+				Segment *segment = reuse(queue);
+				if (segment == nullptr)
+					segment = allocateSegment();
+				else
+					segment->next.store(nullptr, std::memory_order_relaxed);
+
+				// The link is published with the counter below
+				lane.segment->next.store(segment, std::memory_order_relaxed);
+				lane.segment = segment;
+				lane.position = 0;
+			}
 
-		size_t head = _head[queue].load(std::memory_order_relaxed);
+			if (_policy == MultiQueuePopPolicy::OldestFirst)
+				lane.segment->stamps[lane.position] = _epoch.load(std::memory_order_relaxed);
 
-		size_t n0 = std::min(n, _capacity - head);
-		for (size_t i = 0; i < n0; i++) {
-			data[head + i] = elems[i];
-		}
-		for (size_t i = 0; i < (n - n0); i++) {
-			data[i] = elems[n0 + i];
+			lane.segment->data[lane.position++] = elements[e];
 		}
 
-		head = (head + n) % _capacity;
-		_head[queue].store((counter_t) head, std::memory_order_release);
+		counter_t pushed = lane.count.load(std::memory_order_relaxed);
+		lane.count.store(pushed + n, std::memory_order_release);
 	}
 
 	void unsafePop(size_t queue, T __restrict__ values[], size_t n)
@@ -144,19 +312,140 @@ private:
 		assert(n <= _remaining[queue]);
 
 		_remaining[queue] -= n;
-		data_ptr_t data = _data + (queue * _capacity);
 
-		size_t tail = _tail[queue].load(std::memory_order_relaxed);
+		Lane &lane = _consumers[queue];
+
+		size_t i = 0;
+		while (i < n) {
+			// Move to the next segment and recycle the consumed one
+			if (lane.position == SegmentSize) {
+				Segment *next = lane.segment->next.load(std::memory_order_relaxed);
+				assert(next != nullptr);
+
+				recycle(queue, lane.segment);
+				lane.segment = next;
+				lane.position = 0;
+			}
 
-		size_t n0 = std::min(n, _capacity - tail);
-		for (size_t i = 0; i < n0; i++)
-			values[i] = data[tail + i];
+			size_t n0 = std::min(n - i, SegmentSize - lane.position);
+			for (size_t j = 0; j < n0; j++)
+				values[i + j] = lane.segment->data[lane.position + j];
 
-		for (size_t i = 0; i < (n - n0); i++)
-			values[n0 + i] = data[i];
+			lane.position += n0;
+			i += n0;
+		}
 
-		tail = (tail + n) % _capacity;
-		_tail[queue].store((counter_t) tail, std::memory_order_release);
+		counter_t popped = lane.count.load(std::memory_order_relaxed);
+		lane.count.store(popped + n, std::memory_order_release);
+	}
+
+	//! \brief Get the epoch of the next element of a non-empty queue
+	uint64_t peekStamp(size_t queue) const
+	{
+		assert(_remaining[queue] > 0);
+
+		const Lane &lane = _consumers[queue];
+		if (lane.position < SegmentSize)
+			return lane.segment->stamps[lane.position];
+
+		const Segment *next = lane.segment->next.load(std::memory_order_relaxed);
+		assert(next != nullptr);
+		return next->stamps[0];
+	}
+
+	//! \brief Pop the elements of a queue pushed up to an epoch
+	//!
+	//! At least one element is popped
+	//!
+	//! \returns The number of popped elements
+	size_t unsafePopUntil(size_t queue, T __restrict__ values[], size_t n, uint64_t epoch)
+	{
+		assert(n > 0);
+
+		size_t popped = 1;
+		while (popped < n && popped < _remaining[queue]) {
+			// Count the elements without popping them yet
+			const Lane &lane = _consumers[queue];
+			size_t position = lane.position + popped;
+			const Segment *segment = lane.segment;
+			while (position >= SegmentSize) {
+				segment = segment->next.load(std::memory_order_relaxed);
+				position -= SegmentSize;
+			}
+			if (segment->stamps[position] > epoch)
+				break;
+			++popped;
+		}
+
+		unsafePop(queue, values, popped);
+		return popped;
+	}
+
+	//! \brief Give a consumed segment back to the producer of a queue
+	//!
+	//! The segment is kept in the free list of the queue and it is only
+	//! freed when the list is full
+	void recycle(size_t queue, Segment *segment)
+	{
+		Spares &spares = _spares[queue];
+		for (size_t s = 0; s < MaxSpares; s++) {
+			Segment *expected = nullptr;
+			if (spares.slots[s].compare_exchange_strong(expected, segment, std::memory_order_release))
+				return;
+		}
+		freeSegment(segment);
+	}
+
+	//! \brief Take a consumed segment of a queue
+	//!
+	//! \param queue The queue of the producer
+	//!
+	//! \returns The segment or nullptr if the free list is empty
+	Segment *reuse(size_t queue)
+	{
+		Spares &spares = _spares[queue];
+		for (size_t s = 0; s < MaxSpares; s++) {
+			if (spares.slots[s].load(std::memory_order_relaxed) == nullptr)
+				continue;
+
+			Segment *segment = spares.slots[s].exchange(nullptr, std::memory_order_acquire);
+			if (segment != nullptr)
+				return segment;
+		}
+		return nullptr;
+	}
+
+	//! \brief Allocate and construct a segment
+	//!
+	//! The segment is taken from the heap unless the memory is bound to NUMA
+	//! nodes. In that case, it is mapped and bound to the node of the caller
+	//!
+	//! \returns The segment
+	static Segment *allocateSegment()
+	{
+		if (!Memory::isNumaBindingEnabled())
+			return new Segment();
+
+		Segment *segment = Memory::alignedAlloc<Segment>(1, Memory::getCurrentNode());
+		new (segment) Segment();
+		return segment;
+	}
+
+	//! \brief Destroy and free a segment
+	//!
+	//! \param segment The segment or nullptr
+	static void freeSegment(Segment *segment)
+	{
+		if (segment == nullptr)
+			return;
+
+		if (!Memory::isNumaBindingEnabled()) {
+			delete segment;
+			return;
+		}
+
+		segment->~Segment();
+		Memory::alignedFree<Segment>(segment, 1);
 	}
 
 	size_t cyclicRoundRobinPop(T __restrict__ values[], size_t n)
@@ -173,8 +462,7 @@ private:
 			n = std::min<size_t>(n, _totalRemaining);
 		}
 
-		size_t remaining[MaxQueues];
-
+		std::vector<size_t> &remaining = _auxiliary;
 		for (size_t q = 0; q < _queues; ++q)
 			remaining[q] = _remaining[q];
 
@@ -241,16 +529,58 @@ private:
 		return n;
 	}
 
-	bool push(const T &element, size_t queue)
+	size_t oldestFirstPop(T __restrict__ values[], size_t n)
 	{
-		if (_available[queue] == 0) {
-			_available[queue] = getAvailable(queue);
-			if (_available[queue] == 0)
-				return false;
+		if (n == 0)
+			return 0;
+
+		// The elements pushed from now on are newer
+		_epoch.store(_epoch.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		if (_totalRemaining < n) {
+			_totalRemaining = updateRemaining();
+			if (_totalRemaining == 0)
+				return 0;
+
+			n = std::min<size_t>(n, _totalRemaining);
 		}
-		unsafePush(queue, &element, 1);
 
-		return true;
+		_totalRemaining -= n;
+
+		std::vector<size_t> &queues = _auxiliary;
+		size_t nqueues = 0;
+		for (size_t q = 0; q < _queues; ++q) {
+			if (_remaining[q] > 0)
+				queues[nqueues++] = q;
+		}
+
+		size_t i = 0;
+		while (i < n) {
+			// Find the queue with the oldest element and the next oldest epoch
+			size_t oldest = _queues;
+			uint64_t oldestStamp = UINT64_MAX;
+			uint64_t nextStamp = UINT64_MAX;
+			for (size_t c = 0; c < nqueues; ++c) {
+				size_t q = queues[c];
+				if (_remaining[q] == 0)
+					continue;
+
+				uint64_t stamp = peekStamp(q);
+				if (stamp < oldestStamp) {
+					nextStamp = oldestStamp;
+					oldestStamp = stamp;
+					oldest = q;
+				} else if (stamp < nextStamp) {
+					nextStamp = stamp;
+				}
+			}
+			assert(oldest < _queues);
+
+			// Pop from that queue until reaching newer elements
+			i += unsafePopUntil(oldest, values + i, n - i, nextStamp);
+		}
+
+		return n;
 	}
 
 public:
@@ -263,23 +593,46 @@ public:
 		return (_totalRemaining == 0);
 	}
 
+	//! \brief Check whether all the queues are empty
+	//!
+	//! This function can be called by any producer. The elements previously
+	//! pushed by the caller, even from other CPUs, are always observed. The
+	//! queues marked as non-empty are not inspected
+	bool isEmpty() const
+	{
+		for (size_t s = 0; s < _summaryWords; s++) {
+			if (_summary[s].load(std::memory_order_acquire) != 0)
+				return false;
+		}
+
+		// A queue may be unmarked temporarily while the consumer checks it
+		for (size_t q = 0; q < _queues; q++) {
+			counter_t pushed = _producers[q].count.load(std::memory_order_acquire);
+			counter_t popped = _consumers[q].count.load(std::memory_order_acquire);
+			if (pushed != popped)
+				return false;
+		}
+		return true;
+	}
+
 	void push(const T &element)
 	{
+		push(&element, 1);
+	}
+
+	//! \brief Push several elements into the queue of the current CPU
+	//!
+	//! The elements keep their relative order and become visible to the
+	//! consumer at once
+	void push(const T elements[], size_t n)
+	{
+		assert(n > 0);
+
 		size_t queue = TaskingModel::getCurrentLogicalCPU();
 		assert(queue < _queues);
 
-		if (_fullFailure) {
-			if (!push(element, queue))
-				ErrorHandler::fail("MultiLockFreeQueue is full");
-		} else {
-			if (push(element, queue))
-				return;
-
-			do {
-				SpinWait::wait();
-			} while (!push(element, queue));
-			SpinWait::release();
-		}
+		unsafePush(queue, elements, n);
+		markNonEmpty(queue);
 	}
 
 	bool pop(T &element)
@@ -289,10 +642,14 @@ public:
 
 	size_t pop(T __restrict__ values[], size_t n)
 	{
-		if constexpr (Policy == MultiQueuePopPolicy::CyclicRoundRobin)
-			return cyclicRoundRobinPop(values, n);
-		else if constexpr (Policy == MultiQueuePopPolicy::BlockRoundRobin)
-			return blockRoundRobinPop(values, n);
+		switch (_policy) {
+			case MultiQueuePopPolicy::CyclicRoundRobin:
+				return cyclicRoundRobinPop(values, n);
+			case MultiQueuePopPolicy::BlockRoundRobin:
+				return blockRoundRobinPop(values, n);
+			case MultiQueuePopPolicy::OldestFirst:
+				return oldestFirstPop(values, n);
+		}
 		return 0;
 	}
 };
@@ -0,0 +1,116 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#ifndef SEQUENCED_MULTI_LOCK_FREE_QUEUE_HPP
+#define SEQUENCED_MULTI_LOCK_FREE_QUEUE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "MultiLockFreeQueue.hpp"
+#include "Utils.hpp"
+
+
+namespace tampi {
+
+//! Class that provides a multi-producer single-consumer queue that keeps the
+//! global push order. The producers take a ticket from a sequence counter
+//! and push the element into the per-CPU queue of the current CPU without
+//! any lock. The consumer merges the elements of all per-CPU queues and
+//! retrieves them strictly in ticket order. If a ticket is missing because
+//! its producer has not pushed it yet, the following elements are retained
+//! until it arrives
+template <typename T>
+class SequencedMultiLockFreeQueue {
+private:
+	//! Maximum number of elements to retrieve at once from the lanes
+	static constexpr size_t BatchSize = 64;
+
+	//! An element and its ticket
+	struct Entry {
+		uint64_t ticket;
+		T value;
+
+		bool operator>(const Entry &other) const
+		{
+			return ticket > other.ticket;
+		}
+	};
+
+	//! The counter of tickets
+	alignas(CacheAlignment) std::atomic<uint64_t> _tickets;
+
+	//! The per-CPU queues
+	alignas(CacheAlignment) MultiLockFreeQueue<Entry> _lanes;
+
+	//! The next ticket to retrieve
+	uint64_t _next;
+
+	//! The retrieved elements waiting for their turn; a min-heap by ticket
+	std::vector<Entry> _pending;
+
+public:
+	SequencedMultiLockFreeQueue() :
+		_tickets(0),
+		_lanes(MultiQueuePopPolicy::BlockRoundRobin),
+		_next(0),
+		_pending()
+	{
+	}
+
+	//! \brief Push an element to the queue
+	//!
+	//! \param element The element to add
+	void push(const T &element)
+	{
+		uint64_t ticket = _tickets.fetch_add(1, std::memory_order_relaxed);
+		_lanes.push(Entry{ ticket, element });
+	}
+
+	//! \brief Pop multiple elements from the queue in order
+	//!
+	//! \param elements The array to store the retrieved elements
+	//! \param count The maximum number of elements to retrieve
+	//!
+	//! \returns The number of elements retrieved
+	size_t pop(T elements[], size_t count)
+	{
+		assert(elements != nullptr);
+
+		if (count == 0)
+			return 0;
+
+		// Merge the elements available in the lanes
+		Entry entries[BatchSize];
+		size_t retrieved;
+		do {
+			retrieved = _lanes.pop(entries, BatchSize);
+			for (size_t e = 0; e < retrieved; ++e) {
+				_pending.push_back(entries[e]);
+				std::push_heap(_pending.begin(), _pending.end(), std::greater<Entry>());
+			}
+		} while (retrieved == BatchSize);
+
+		// Retrieve the consecutive elements from the next ticket
+		size_t popped = 0;
+		while (popped < count && !_pending.empty() && _pending.front().ticket == _next) {
+			elements[popped++] = _pending.front().value;
+			std::pop_heap(_pending.begin(), _pending.end(), std::greater<Entry>());
+			_pending.pop_back();
+			++_next;
+		}
+		return popped;
+	}
+};
+
+} // namespace tampi
+
+#endif // SEQUENCED_MULTI_LOCK_FREE_QUEUE_HPP
@@ -1,13 +1,14 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef SPIN_LOCK_HPP
 #define SPIN_LOCK_HPP
 
 #include <atomic>
+#include <unistd.h>
 
 #include "SpinWait.hpp"
 #include "Utils.hpp"
@@ -17,29 +18,47 @@ namespace tampi {
 
 //! Class that implements a ticket array spinlock that focuses on
 //! avoiding the overhead when there are many threads trying to
-//! acquire the lock at the same time
+//! acquire the lock at the same time. The array has a slot per CPU
+//! of the system, so each waiting thread usually spins on its own
+//! slot. The lock remains correct with more threads than slots
 class SpinLock {
 private:
-	static constexpr size_t Size = MaxSystemCPUs;
+	//! The number of slots of the array
+	const size_t _size;
 
-	alignas(CacheAlignment) PaddedArray<std::atomic<size_t>, Size> _buffer;
+	alignas(CacheAlignment) PaddedArray<std::atomic<size_t>> _buffer;
 	alignas(CacheAlignment) std::atomic<size_t> _head;
 	alignas(CacheAlignment) size_t _next;
 
+	//! \brief Get the number of slots
+	//!
+	//! The spinlocks may be constructed before the tasking model is
+	//! initialized, so the system is queried directly
+	static size_t getNumSlots()
+	{
+		static const long ncpus = sysconf(_SC_NPROCESSORS_CONF);
+		return (ncpus > 0) ? (size_t) ncpus : 1;
+	}
+
 public:
 	SpinLock() :
+		_size(getNumSlots()),
+		_buffer(_size),
 		_head(0),
 		_next(0)
 	{
-		for (size_t i = 0; i < Size; ++i)
+		for (size_t i = 0; i < _size; ++i)
 			std::atomic_init(&_buffer[i], (size_t) 0);
 	}
 
+	SpinLock(const SpinLock &) = delete;
+	const SpinLock& operator= (const SpinLock &) = delete;
+
 	//! \brief Aquire the spinlock
 	void lock()
 	{
 		const size_t head = _head.fetch_add(1, std::memory_order_relaxed);
-		const size_t idx = head % Size;
+		const size_t idx = head % _size;
 		while (_buffer[idx].load(std::memory_order_relaxed) != head) {
 			SpinWait::wait();
 		}
@@ -54,7 +73,7 @@ public:
 	bool try_lock()
 	{
 		size_t head = _head.load(std::memory_order_relaxed);
-		const size_t idx = head % Size;
+		const size_t idx = head % _size;
 		if (_buffer[idx].load(std::memory_order_relaxed) != head)
 			return false;
 
@@ -67,7 +86,7 @@ public:
 	//! \brief Release the spinlock
 	void unlock()
 	{
-		const size_t idx = ++_next % Size;
+		const size_t idx = ++_next % _size;
 		_buffer[idx].store(_next, std::memory_order_release);
 	}
 };
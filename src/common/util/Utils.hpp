@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef UTILS_HPP
@@ -14,18 +14,21 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <new>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "EnvironmentVariable.hpp"
+#include "ErrorHandler.hpp"
 
 #ifndef CACHELINE_SIZE
 #define CACHELINE_SIZE 64
 #endif
 
-#ifndef MAX_SYSTEM_CPUS
-#define MAX_SYSTEM_CPUS 64
-#endif
-
 
 namespace tampi {
 
@@ -33,9 +36,6 @@ namespace tampi {
 //! false sharing between objects
 constexpr size_t CacheAlignment = CACHELINE_SIZE * 2;
 
-//! The maximum number of CPUs in the system
-constexpr size_t MaxSystemCPUs = MAX_SYSTEM_CPUS;
-
 //! Class that provides padding for a type
 template <class T, size_t Size = CacheAlignment>
 class Padded {
@@ -77,27 +77,58 @@ public:
 	}
 };
 
-//! Class that provides a padded array
-template <class T, size_t Capacity, size_t Padding = CacheAlignment>
+//! Class that provides a padded array. The size is decided at run-time,
+//! usually the number of CPUs, and the objects are default constructed
+template <class T, size_t Padding = CacheAlignment>
 class PaddedArray {
+	typedef Padded<T, Padding> Data;
+
 	//! The array of objects
-	Padded<T, Padding> _data[Capacity];
+	Data *_data;
+
+	//! The number of objects
+	size_t _size;
 
 public:
-	PaddedArray()
+	//! \brief Construct a padded array
+	//!
+	//! \param size The number of objects
+	PaddedArray(size_t size) :
+		_data((Data *) ::operator new(sizeof(Data) * size, std::align_val_t(CacheAlignment))),
+		_size(size)
 	{
 		assert((uintptr_t) _data % CacheAlignment == 0);
+
+		for (size_t i = 0; i < _size; ++i)
+			new (&_data[i]) Data();
+	}
+
+	PaddedArray(const PaddedArray &) = delete;
+	const PaddedArray& operator= (const PaddedArray &) = delete;
+
+	~PaddedArray()
+	{
+		for (size_t i = 0; i < _size; ++i)
+			_data[i].~Data();
+
+		::operator delete((void *) _data, std::align_val_t(CacheAlignment));
+	}
+
+	//! \brief Get the number of objects
+	size_t size() const
+	{
+		return _size;
 	}
 
 	T &operator[](size_t i)
 	{
-		assert(i < Capacity);
+		assert(i < _size);
 		return _data[i].get();
 	}
 
 	const T &operator[](size_t i) const
 	{
-		assert(i < Capacity);
+		assert(i < _size);
 		return _data[i].get();
 	}
 };
@@ -129,24 +160,128 @@ public:
 	}
 };
 
-//! Class that provides memory allocation utilities
+//! Class that provides memory allocation utilities. The memory of the internal
+//! arenas can be bound to a NUMA node and backed by huge pages. The binding
+//! sets the preferred node of the pages, so the allocation does not fail if
+//! the node runs out of memory. Only the allocations of at least half a huge
+//! page are backed by huge pages to avoid wasting memory, and their mappings
+//! are rounded up and aligned to whole huge pages
 class Memory {
 public:
+	//! The policies to back the memory with huge pages
+	enum HugePagesPolicy {
+		NoHugePages = 0,
+		TransparentHugePages,
+		ExplicitHugePages
+	};
+
+	//! The value representing no specific NUMA node
+	static constexpr int AnyNode = -1;
+
+	//! The size of the huge pages
+	static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+private:
+	//! The maximum number of NUMA nodes supported by the binding
+	static constexpr size_t MaxNodes = 1024;
+
+	//! The policy to back the memory with huge pages
+	static HugePagesPolicy _hugePages;
+
+	//! Whether the memory is bound to NUMA nodes
+	static bool _numaBinding;
+
+public:
+	//! \brief Initialize the memory placement policies
+	//!
+	//! This function must be called before allocating memory
+	static void initialize()
+	{
+		EnvironmentVariable<std::string> hugePages("TAMPI_MEMORY_HUGEPAGES", "none");
+		EnvironmentVariable<bool> numaBinding("TAMPI_MEMORY_NUMA", false);
+
+		if (hugePages.get() == "none")
+			_hugePages = NoHugePages;
+		else if (hugePages.get() == "transparent")
+			_hugePages = TransparentHugePages;
+		else if (hugePages.get() == "explicit")
+			_hugePages = ExplicitHugePages;
+		else
+			ErrorHandler::fail("TAMPI_MEMORY_HUGEPAGES has an invalid policy '", hugePages.get(), "'");
+
+		_numaBinding = numaBinding;
+	}
+
+	//! \brief Check whether the memory is bound to NUMA nodes
+	static bool isNumaBindingEnabled()
+	{
+		return _numaBinding;
+	}
+
+	//! \brief Get the NUMA node of the current CPU
+	//!
+	//! \returns The node or AnyNode if the binding is disabled or unknown
+	static int getCurrentNode()
+	{
+		if (!_numaBinding)
+			return AnyNode;
+
+		unsigned cpu, node;
+		if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+			return AnyNode;
+		return (int) node;
+	}
+
+	//! \brief Get the number of objects to allocate at once
+	//!
+	//! The number is increased to fill a huge page if they are enabled
+	//!
+	//! \param n The minimum number of objects (of type T)
+	//!
+	//! \returns The number of objects
+	template <typename T>
+	static size_t getPreferredCount(size_t n)
+	{
+		if (_hugePages == NoHugePages || sizeof(T) * n >= HugePageSize)
+			return n;
+		return HugePageSize / sizeof(T);
+	}
+
 	//! \brief Allocate aligned memory for several objects
 	//!
 	//! The operation only allocates memory; it does not construct the objects
 	//!
 	//! \param n The number of objects (of type T) to allocate
+	//! \param node The NUMA node where to place the memory
 	//!
 	//! \returns The pointer to the objects
 	template <typename T>
-	static T *alignedAlloc(size_t n)
+	static T *alignedAlloc(size_t n, int node = AnyNode)
 	{
-		void *ptr = mmap(NULL, sizeof(T) * n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, 0, 0);
+		const bool hugePages = useHugePages(sizeof(T) * n);
+		size_t size = getMappingSize(sizeof(T) * n);
+		void *ptr = MAP_FAILED;
+
+		// The transparent huge pages only apply to private anonymous memory
+		// and to the ranges aligned to a huge page. Fall back to regular pages
+		// if there are no explicit huge pages available
+		if (hugePages && _hugePages == ExplicitHugePages)
+			ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		else if (hugePages && _hugePages == TransparentHugePages)
+			ptr = mapHugePageAligned(size);
+		if (ptr == MAP_FAILED)
+			ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
 		if (ptr == MAP_FAILED)
 			ErrorHandler::fail("Failed to allocate aligned memory");
 		if ((uintptr_t) ptr % CacheAlignment != 0)
 			ErrorHandler::fail("Aligned memory is not aligned to ", CacheAlignment);
+
+		// The placement is a hint; ignore the failures
+		if (hugePages && _hugePages == TransparentHugePages && (uintptr_t) ptr % HugePageSize == 0)
+			madvise(ptr, size, MADV_HUGEPAGE);
+		if (_numaBinding && node != AnyNode)
+			bind(ptr, size, node);
+
 		return (T *) ptr;
 	}
 
@@ -160,7 +295,80 @@ public:
 	template <typename T>
 	static void alignedFree(T *data, size_t n)
 	{
-		munmap(data, sizeof(T) * n);
+		munmap(data, getMappingSize(sizeof(T) * n));
+	}
+
+private:
+	//! \brief Get the size of the mapping holding an allocation
+	//!
+	//! \param size The size of the allocation in bytes
+	//!
+	//! \returns The size of the mapping in bytes
+	static size_t getMappingSize(size_t size)
+	{
+		if (useHugePages(size))
+			return ((size + HugePageSize - 1) / HugePageSize) * HugePageSize;
+		return size;
+	}
+
+	//! \brief Check whether an allocation is backed by huge pages
+	//!
+	//! The slabs enlarged to fill a huge page may be slightly smaller than a
+	//! huge page, so the allocations of at least half a huge page qualify
+	//!
+	//! \param size The size of the allocation in bytes
+	static bool useHugePages(size_t size)
+	{
+		return (_hugePages != NoHugePages && size >= HugePageSize / 2);
+	}
+
+	//! \brief Map private anonymous memory aligned to a huge page
+	//!
+	//! An extra huge page is mapped and the unaligned head and the remaining
+	//! tail are unmapped
+	//!
+	//! \param size The size of the mapping; a multiple of the huge page size
+	//!
+	//! \returns The aligned pointer or MAP_FAILED
+	static void *mapHugePageAligned(size_t size)
+	{
+		assert(size % HugePageSize == 0);
+
+		const size_t extended = size + HugePageSize;
+		void *ptr = mmap(NULL, extended, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED)
+			return MAP_FAILED;
+
+		uintptr_t start = (uintptr_t) ptr;
+		uintptr_t aligned = (start + HugePageSize - 1) & ~((uintptr_t) HugePageSize - 1);
+		if (aligned > start)
+			munmap(ptr, aligned - start);
+
+		uintptr_t end = start + extended;
+		if (end > aligned + size)
+			munmap((void *) (aligned + size), end - (aligned + size));
+
+		return (void *) aligned;
+	}
+
+	//! \brief Set the preferred NUMA node of a memory region
+	//!
+	//! \param ptr The page-aligned pointer to the region
+	//! \param size The size of the region in bytes
+	//! \param node The NUMA node
+	static void bind(void *ptr, size_t size, int node)
+	{
+		// The policy and mask definitions of the mbind system call
+		constexpr int PreferredPolicy = 1;
+		constexpr size_t WordBits = sizeof(unsigned long) * 8;
+
+		if (node < 0 || (size_t) node >= MaxNodes)
+			return;
+
+		unsigned long mask[MaxNodes / WordBits] = {};
+		mask[node / WordBits] = 1UL << (node % WordBits);
+
+		syscall(SYS_mbind, ptr, size, PreferredPolicy, mask, MaxNodes + 1, 0);
 	}
 };
 
@@ -1,7 +1,7 @@
 /*
 	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 
-	Copyright (C) 2015-2024 Barcelona Supercomputing Center (BSC)
+	Copyright (C) 2015-2026 Barcelona Supercomputing Center (BSC)
 */
 
 #ifndef TAMPI_WRAPPERS_H
@@ -32,6 +32,150 @@ int TAMPI_Isend(const void *buf, int count, MPI_Datatype datatype,
 int TAMPI_Issend(const void *buf, int count, MPI_Datatype datatype,
 		int source, int tag, MPI_Comm comm);
 
+//! The kinds of point-to-point operations that can be submitted in a batch
+#define TAMPI_BATCH_SEND  0x1
+#define TAMPI_BATCH_BSEND 0x2
+#define TAMPI_BATCH_RSEND 0x3
+#define TAMPI_BATCH_SSEND 0x4
+#define TAMPI_BATCH_RECV  0x5
+
+//! The description of a point-to-point operation submitted in a batch. The
+//! peer is the destination of sends and the source of receives, and the
+//! status is only saved for receives; it can be MPI_STATUS_IGNORE
+typedef struct {
+	int kind;
+	void *buf;
+	int count;
+	MPI_Datatype datatype;
+	int peer;
+	int tag;
+	MPI_Status *status;
+} TAMPI_Batch_op;
+
+//! Functions to submit several point-to-point operations at once. The events
+//! of the calling task are increased once, and they are fulfilled when all the
+//! operations complete
+int TAMPI_Isendv(int count, const void *const bufs[], const int counts[],
+		const MPI_Datatype datatypes[], const int dests[], const int tags[],
+		MPI_Comm comm);
+
+int TAMPI_Irecvv(int count, void *const bufs[], const int counts[],
+		const MPI_Datatype datatypes[], const int sources[], const int tags[],
+		MPI_Comm comm, MPI_Status statuses[]);
+
+int TAMPI_Ibatch(int count, const TAMPI_Batch_op ops[], MPI_Comm comm);
+
+//! Functions to create persistent point-to-point requests and to start them
+//! from tasks. The events of the calling task are fulfilled when the started
+//! requests complete. The persistent requests of all kinds are freed with
+//! TAMPI_Request_free, which also forgets them in TAMPI
+int TAMPI_Recv_init(void *buf, int count, MPI_Datatype datatype, int source,
+		int tag, MPI_Comm comm, MPI_Request *request);
+
+int TAMPI_Send_init(const void *buf, int count, MPI_Datatype datatype,
+		int dest, int tag, MPI_Comm comm, MPI_Request *request);
+
+int TAMPI_Start(MPI_Request *request, MPI_Status *status);
+
+int TAMPI_Startall(int count, MPI_Request requests[], MPI_Status statuses[]);
+
+int TAMPI_Request_free(MPI_Request *request);
+
+//! Functions to create partitioned requests and to bind tasks to their
+//! partitions. The requests are started with TAMPI_Start and TAMPI_Startall.
+//! The events of the task marking a partition as ready are fulfilled when the
+//! round completes, and the events of the task waiting for a partition are
+//! fulfilled when the partition arrives
+int TAMPI_Precv_init(void *buf, int partitions, MPI_Count count,
+		MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request);
+
+int TAMPI_Psend_init(const void *buf, int partitions, MPI_Count count,
+		MPI_Datatype datatype, int dest, int tag, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request);
+
+int TAMPI_Pready(int partition, MPI_Request request);
+
+int TAMPI_Parrived(MPI_Request request, int partition);
+
+//! Functions to create persistent collective requests. The requests are
+//! started from tasks through TAMPI_Start and TAMPI_Startall and are freed
+//! with TAMPI_Request_free. They require MPI persistent collectives support
+int TAMPI_Allgather_init(const void *sendbuf, int sendcount,
+		MPI_Datatype sendtype, void *recvbuf, int recvcount,
+		MPI_Datatype recvtype, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Allgatherv_init(const void *sendbuf, int sendcount,
+		MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+		const int displs[], MPI_Datatype recvtype, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request);
+
+int TAMPI_Allreduce_init(const void *sendbuf, void *recvbuf, int count,
+		MPI_Datatype datatype, MPI_Op op, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Alltoall_init(const void *sendbuf, int sendcount,
+		MPI_Datatype sendtype, void *recvbuf, int recvcount,
+		MPI_Datatype recvtype, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Alltoallv_init(const void *sendbuf, const int sendcounts[],
+		const int sdispls[], MPI_Datatype sendtype, void *recvbuf,
+		const int recvcounts[], const int rdispls[],
+		MPI_Datatype recvtype, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Alltoallw_init(const void *sendbuf, const int sendcounts[],
+		const int sdispls[], const MPI_Datatype sendtypes[],
+		void *recvbuf, const int recvcounts[], const int rdispls[],
+		const MPI_Datatype recvtypes[], MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Barrier_init(MPI_Comm comm, MPI_Info info, MPI_Request *request);
+
+int TAMPI_Bcast_init(void *buffer, int count, MPI_Datatype datatype, int root,
+		MPI_Comm comm, MPI_Info info, MPI_Request *request);
+
+int TAMPI_Exscan_init(const void *sendbuf, void *recvbuf, int count,
+		MPI_Datatype datatype, MPI_Op op, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Gather_init(const void *sendbuf, int sendcount, MPI_Datatype sendtype,
+		void *recvbuf, int recvcount, MPI_Datatype recvtype, int root,
+		MPI_Comm comm, MPI_Info info, MPI_Request *request);
+
+int TAMPI_Gatherv_init(const void *sendbuf, int sendcount,
+		MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+		const int displs[], MPI_Datatype recvtype, int root,
+		MPI_Comm comm, MPI_Info info, MPI_Request *request);
+
+int TAMPI_Reduce_init(const void *sendbuf, void *recvbuf, int count,
+		MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request);
+
+int TAMPI_Reduce_scatter_init(const void *sendbuf, void *recvbuf,
+		const int recvcounts[], MPI_Datatype datatype, MPI_Op op,
+		MPI_Comm comm, MPI_Info info, MPI_Request *request);
+
+int TAMPI_Reduce_scatter_block_init(const void *sendbuf, void *recvbuf,
+		int recvcount, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request);
+
+int TAMPI_Scan_init(const void *sendbuf, void *recvbuf, int count,
+		MPI_Datatype datatype, MPI_Op op, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Scatter_init(const void *sendbuf, int sendcount,
+		MPI_Datatype sendtype, void *recvbuf, int recvcount,
+		MPI_Datatype recvtype, int root, MPI_Comm comm, MPI_Info info,
+		MPI_Request *request);
+
+int TAMPI_Scatterv_init(const void *sendbuf, const int sendcounts[],
+		const int displs[], MPI_Datatype sendtype, void *recvbuf,
+		int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm,
+		MPI_Info info, MPI_Request *request);
+
 int TAMPI_Iallgather(const void *sendbuf, int sendcount,
 		MPI_Datatype sendtype, void *recvbuf, int recvcount,
 		MPI_Datatype recvtype, MPI_Comm comm);
@@ -0,0 +1,138 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+#include <TAMPI.h>
+
+#include "Utils.hpp"
+
+#include <vector>
+
+#ifdef LARGE_INPUT
+const int TIMESTEPS = 1000;
+const int MSG_NUM = 100;
+const int MSG_SIZE = 100;
+#else
+const int TIMESTEPS = 500;
+const int MSG_NUM = 80;
+const int MSG_SIZE = 100;
+#endif
+
+int main(int argc, char **argv)
+{
+	int provided;
+	const int required = MPI_THREAD_MULTIPLE;
+	CHECK(MPI_Init_thread(&argc, &argv, required, &provided));
+	ASSERT(provided == required);
+
+	int rank, size;
+	CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+	CHECK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+	ASSERT(size > 1);
+
+	const int next = (rank + 1) % size;
+	const int prev = (rank + size - 1) % size;
+
+	int * const sendBuffer = (int *) std::malloc(MSG_NUM * MSG_SIZE * sizeof(int));
+	int * const recvBuffer = (int *) std::malloc(MSG_NUM * MSG_SIZE * sizeof(int));
+	ASSERT(sendBuffer != nullptr);
+	ASSERT(recvBuffer != nullptr);
+
+	// Describe the batches of messages exchanged with the neighbours
+	std::vector<const void *> sendBufs(MSG_NUM);
+	std::vector<void *> recvBufs(MSG_NUM);
+	std::vector<int> counts(MSG_NUM, MSG_SIZE);
+	std::vector<MPI_Datatype> datatypes(MSG_NUM, MPI_INT);
+	std::vector<int> dests(MSG_NUM, next);
+	std::vector<int> sources(MSG_NUM, prev);
+	std::vector<int> tags(MSG_NUM);
+	std::vector<MPI_Status> statuses(MSG_NUM);
+	std::vector<TAMPI_Batch_op> ops(2 * MSG_NUM);
+
+	for (int m = 0; m < MSG_NUM; ++m) {
+		sendBufs[m] = sendBuffer + m * MSG_SIZE;
+		recvBufs[m] = recvBuffer + m * MSG_SIZE;
+		tags[m] = m;
+	}
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+	double startTime = getTime();
+
+	for (int t = 0; t < TIMESTEPS; ++t) {
+		#pragma oss task out(sendBuffer[0;MSG_NUM*MSG_SIZE]) label("init")
+		for (int d = 0; d < MSG_NUM * MSG_SIZE; ++d) {
+			sendBuffer[d] = rank + t + d;
+		}
+
+		if (t % 2 == 0) {
+			#pragma oss task in(sendBuffer[0;MSG_NUM*MSG_SIZE]) label("isendv")
+			{
+				CHECK(TAMPI_Isendv(MSG_NUM, sendBufs.data(), counts.data(), datatypes.data(),
+					dests.data(), tags.data(), MPI_COMM_WORLD));
+			}
+
+			#pragma oss task out(recvBuffer[0;MSG_NUM*MSG_SIZE], statuses) label("irecvv")
+			{
+				CHECK(TAMPI_Irecvv(MSG_NUM, recvBufs.data(), counts.data(), datatypes.data(),
+					sources.data(), tags.data(), MPI_COMM_WORLD, statuses.data()));
+			}
+		} else {
+			// Submit the sends and the receives of the timestep in a single batch
+			#pragma oss task in(sendBuffer[0;MSG_NUM*MSG_SIZE]) out(recvBuffer[0;MSG_NUM*MSG_SIZE], statuses) label("ibatch")
+			{
+				for (int m = 0; m < MSG_NUM; ++m) {
+					TAMPI_Batch_op &recv = ops[2 * m];
+					recv.kind = TAMPI_BATCH_RECV;
+					recv.buf = recvBufs[m];
+					recv.count = MSG_SIZE;
+					recv.datatype = MPI_INT;
+					recv.peer = prev;
+					recv.tag = m;
+					recv.status = &statuses[m];
+
+					TAMPI_Batch_op &send = ops[2 * m + 1];
+					send.kind = TAMPI_BATCH_SEND;
+					send.buf = sendBuffer + m * MSG_SIZE;
+					send.count = MSG_SIZE;
+					send.datatype = MPI_INT;
+					send.peer = next;
+					send.tag = m;
+					send.status = MPI_STATUS_IGNORE;
+				}
+				CHECK(TAMPI_Ibatch(2 * MSG_NUM, ops.data(), MPI_COMM_WORLD));
+			}
+		}
+
+		#pragma oss task in(recvBuffer[0;MSG_NUM*MSG_SIZE], statuses) label("check")
+		for (int m = 0; m < MSG_NUM; ++m) {
+			ASSERT(statuses[m].MPI_TAG == m);
+			ASSERT(statuses[m].MPI_SOURCE == prev);
+
+			int count;
+			CHECK(MPI_Get_count(&statuses[m], MPI_INT, &count));
+			ASSERT(count == MSG_SIZE);
+
+			for (int d = 0; d < MSG_SIZE; ++d) {
+				ASSERT(recvBuffer[m * MSG_SIZE + d] == prev + t + m * MSG_SIZE + d);
+			}
+		}
+	}
+	#pragma oss taskwait
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+	if (rank == 0) {
+		double endTime = getTime();
+		fprintf(stdout, "Success, time: %f\n", endTime - startTime);
+	}
+
+	CHECK(MPI_Finalize());
+
+	std::free(sendBuffer);
+	std::free(recvBuffer);
+
+	return 0;
+}
@@ -0,0 +1,103 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+#include <TAMPI.h>
+
+#include "Utils.hpp"
+
+#ifdef LARGE_INPUT
+const int TIMESTEPS = 1000;
+const int PARTITIONS = 64;
+const int PART_SIZE = 1000;
+#else
+const int TIMESTEPS = 500;
+const int PARTITIONS = 32;
+const int PART_SIZE = 500;
+#endif
+
+MPI_Request request;
+
+int main(int argc, char **argv)
+{
+	int provided;
+	const int required = MPI_THREAD_MULTIPLE;
+	CHECK(MPI_Init_thread(&argc, &argv, required, &provided));
+	ASSERT(provided == required);
+
+	int rank, size;
+	CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+	CHECK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+	ASSERT(size > 1);
+
+	int * const buffer = (int *) std::malloc(PARTITIONS * PART_SIZE * sizeof(int));
+	ASSERT(buffer != nullptr);
+
+	// Create the partitioned requests once
+	if (rank == 0) {
+		CHECK(TAMPI_Psend_init(buffer, PARTITIONS, PART_SIZE, MPI_INT, 1, 0, MPI_COMM_WORLD, MPI_INFO_NULL, &request));
+	} else if (rank == 1) {
+		CHECK(TAMPI_Precv_init(buffer, PARTITIONS, PART_SIZE, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_INFO_NULL, &request));
+	}
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+	double startTime = getTime();
+
+	for (int t = 0; t < TIMESTEPS; ++t) {
+		if (rank > 1)
+			break;
+
+		#pragma oss task inout(request) label("start")
+		{
+			CHECK(TAMPI_Start(&request, MPI_STATUS_IGNORE));
+		}
+
+		for (int p = 0; p < PARTITIONS; ++p) {
+			int *partition = buffer + p * PART_SIZE;
+
+			if (rank == 0) {
+				// Each task produces a partition and marks it as ready
+				#pragma oss task out(partition[0;PART_SIZE]) in(request) label("produce")
+				{
+					for (int d = 0; d < PART_SIZE; ++d) {
+						partition[d] = t + p * PART_SIZE + d;
+					}
+					CHECK(TAMPI_Pready(p, request));
+				}
+			} else {
+				// Wait for the partition and consume it once arrived
+				#pragma oss task out(partition[0;PART_SIZE]) in(request) label("arrived")
+				{
+					CHECK(TAMPI_Parrived(request, p));
+				}
+
+				// The next start waits for the consumption of the partition
+				#pragma oss task in(partition[0;PART_SIZE]) in(request) label("consume")
+				for (int d = 0; d < PART_SIZE; ++d) {
+					ASSERT(partition[d] == t + p * PART_SIZE + d);
+				}
+			}
+		}
+	}
+	#pragma oss taskwait
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+	if (rank == 0) {
+		double endTime = getTime();
+		fprintf(stdout, "Success, time: %f\n", endTime - startTime);
+	}
+
+	if (rank < 2) {
+		CHECK(TAMPI_Request_free(&request));
+	}
+
+	CHECK(MPI_Finalize());
+
+	std::free(buffer);
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+#include <TAMPI.h>
+
+#include "Utils.hpp"
+
+#ifdef LARGE_INPUT
+const int TIMESTEPS = 5000;
+const int SIZE = 1000;
+#else
+const int TIMESTEPS = 2000;
+const int SIZE = 500;
+#endif
+
+int values[SIZE];
+int sums[SIZE];
+int params[SIZE];
+
+MPI_Request requests[2];
+
+int main(int argc, char **argv)
+{
+	int provided;
+	const int required = MPI_THREAD_MULTIPLE;
+	CHECK(MPI_Init_thread(&argc, &argv, required, &provided));
+	ASSERT(provided == required);
+
+	int rank, size;
+	CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+	CHECK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+	// Create the persistent collectives once
+	CHECK(TAMPI_Allreduce_init(values, sums, SIZE, MPI_INT, MPI_SUM, MPI_COMM_WORLD, MPI_INFO_NULL, &requests[0]));
+	CHECK(TAMPI_Bcast_init(params, SIZE, MPI_INT, 0, MPI_COMM_WORLD, MPI_INFO_NULL, &requests[1]));
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+	double startTime = getTime();
+
+	for (int t = 0; t < TIMESTEPS; ++t) {
+		#pragma oss task out(values, params) label("init")
+		for (int d = 0; d < SIZE; ++d) {
+			values[d] = rank + t + d;
+			params[d] = (rank == 0) ? t * d : -1;
+		}
+
+		if (t % 2 == 0) {
+			#pragma oss task in(values) out(sums) inout(requests[0]) label("allreduce")
+			{
+				CHECK(TAMPI_Start(&requests[0], MPI_STATUS_IGNORE));
+			}
+
+			#pragma oss task inout(params, requests[1]) label("bcast")
+			{
+				CHECK(TAMPI_Start(&requests[1], MPI_STATUS_IGNORE));
+			}
+		} else {
+			// Start both collectives at once, which keeps their order
+			#pragma oss task in(values) out(sums) inout(params, requests) label("startall")
+			{
+				CHECK(TAMPI_Startall(2, requests, MPI_STATUSES_IGNORE));
+			}
+		}
+
+		#pragma oss task in(sums, params) label("check")
+		for (int d = 0; d < SIZE; ++d) {
+			ASSERT(sums[d] == size * (size - 1) / 2 + size * (t + d));
+			ASSERT(params[d] == t * d);
+		}
+	}
+	#pragma oss taskwait
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+	if (rank == 0) {
+		double endTime = getTime();
+		fprintf(stdout, "Success, time: %f\n", endTime - startTime);
+	}
+
+	CHECK(TAMPI_Request_free(&requests[0]));
+	CHECK(TAMPI_Request_free(&requests[1]));
+
+	CHECK(MPI_Finalize());
+
+	return 0;
+}
@@ -0,0 +1,113 @@
+/*
+	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
+
+	Copyright (C) 2026 Barcelona Supercomputing Center (BSC)
+*/
+
+#include <mpi.h>
+#include <TAMPI.h>
+
+#include "Utils.hpp"
+
+#include <vector>
+
+#ifdef LARGE_INPUT
+const int TIMESTEPS = 1000;
+const int MSG_NUM = 1000;
+const int MSG_SIZE = 100;
+#else
+const int TIMESTEPS = 500;
+const int MSG_NUM = 500;
+const int MSG_SIZE = 100;
+#endif
+
+MPI_Request requests[MSG_NUM];
+MPI_Status statuses[MSG_NUM];
+
+int main(int argc, char **argv)
+{
+	int provided;
+	const int required = MPI_THREAD_MULTIPLE;
+	CHECK(MPI_Init_thread(&argc, &argv, required, &provided));
+	ASSERT(provided == required);
+
+	int rank, size;
+	CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+	CHECK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+	ASSERT(size > 1);
+
+	int * const buffer = (int *) std::malloc(MSG_NUM * MSG_SIZE * sizeof(int));
+	ASSERT(buffer != nullptr);
+
+	// Create the persistent requests once
+	for (int m = 0; m < MSG_NUM; ++m) {
+		int *message = buffer + m * MSG_SIZE;
+		if (rank == 0) {
+			CHECK(TAMPI_Send_init(message, MSG_SIZE, MPI_INT, 1, m, MPI_COMM_WORLD, &requests[m]));
+		} else if (rank == 1) {
+			CHECK(TAMPI_Recv_init(message, MSG_SIZE, MPI_INT, 0, m, MPI_COMM_WORLD, &requests[m]));
+		}
+	}
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+	double startTime = getTime();
+
+	for (int t = 0; t < TIMESTEPS; ++t) {
+		if (rank == 0) {
+			int *message = buffer;
+
+			for (int m = 0; m < MSG_NUM; ++m) {
+				#pragma oss task out(message[0;MSG_SIZE]) label("init")
+				for (int d = 0; d < MSG_SIZE; ++d) {
+					message[d] = t + d;
+				}
+
+				#pragma oss task in(message[0;MSG_SIZE]) inout(requests[m]) label("start")
+				{
+					CHECK(TAMPI_Start(&requests[m], MPI_STATUS_IGNORE));
+				}
+				message += MSG_SIZE;
+			}
+		} else if (rank == 1) {
+			// Start all the receives of the timestep at once
+			#pragma oss task out(buffer[0;MSG_NUM*MSG_SIZE], statuses) inout(requests) label("startall")
+			{
+				CHECK(TAMPI_Startall(MSG_NUM, requests, statuses));
+			}
+
+			#pragma oss task in(buffer[0;MSG_NUM*MSG_SIZE], statuses) label("check")
+			for (int m = 0; m < MSG_NUM; ++m) {
+				const int *message = buffer + m * MSG_SIZE;
+				for (int d = 0; d < MSG_SIZE; ++d) {
+					ASSERT(message[d] == t + d);
+				}
+				ASSERT(statuses[m].MPI_TAG == m);
+				ASSERT(statuses[m].MPI_SOURCE == 0);
+
+				int count;
+				CHECK(MPI_Get_count(&statuses[m], MPI_INT, &count));
+				ASSERT(count == MSG_SIZE);
+			}
+		}
+	}
+	#pragma oss taskwait
+
+	CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+	if (rank == 0) {
+		double endTime = getTime();
+		fprintf(stdout, "Success, time: %f\n", endTime - startTime);
+	}
+
+	if (rank < 2) {
+		for (int m = 0; m < MSG_NUM; ++m) {
+			CHECK(TAMPI_Request_free(&requests[m]));
+		}
+	}
+
+	CHECK(MPI_Finalize());
+
+	std::free(buffer);
+
+	return 0;
+}
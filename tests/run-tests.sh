@@ -1,7 +1,7 @@
 #!/usr/bin/env bash
 #	This file is part of Task-Aware MPI and is licensed under the terms contained in the COPYING and COPYING.LESSER files.
 #
-#	Copyright (C) 2023-2025 Barcelona Supercomputing Center (BSC)
+#	Copyright (C) 2023-2026 Barcelona Supercomputing Center (BSC)
 
 set -Eo pipefail
 
@@ -47,6 +47,17 @@ function find_binary {
 	exit 44 # exit from subshell
 }
 
+# Check whether the MPI library provides a feature by linking a program, like
+# the configure checks. The arguments are the includes and the statements
+function has_mpi_feature {
+	local probe="$out_dir/tampi.probe"
+	echo -e "$1\nint main() { MPI_Request request; $2; return 0; }" > "$probe.cpp"
+	$mpicxx "$probe.cpp" -o "$probe" &> /dev/null
+	local ret=$?
+	rm -f "$probe.cpp" "$probe"
+	return $ret
+}
+
 function check_binaries {
 	for bin in "$@"; do
 		if ! command -v "$bin" &> /dev/null; then
@@ -210,6 +221,7 @@ fi
 echo ""
 
 progs=(
+	BatchNonBlk.oss.{nodes,nanos6}.test
 	CollectiveBlk.oss.{nodes,nanos6}.test
 	CollectiveNonBlk.omp.test
 	CollectiveNonBlk.oss.{nodes,nanos6}.test
@@ -222,6 +234,9 @@ progs=(
 	MultiPrimitiveBlk.oss.{nodes,nanos6}.test
 	MultiPrimitiveNonBlk.omp.test
 	MultiPrimitiveNonBlk.oss.{nodes,nanos6}.test
+	PartitionedNonBlk.oss.{nodes,nanos6}.test
+	PersistentCollectiveNonBlk.oss.{nodes,nanos6}.test
+	PersistentNonBlk.oss.{nodes,nanos6}.test
 	PrimitiveBlk.oss.{nodes,nanos6}.test
 	PrimitiveNonBlk.omp.test
 	PrimitiveNonBlk.oss.{nodes,nanos6}.test
@@ -237,6 +252,22 @@ fi
 
 make -f $makefile -B -s ${progs[*]} $compile_args
 
+# Skip the tests of the features that the MPI library does not support
+skip_partitioned=0
+if ! has_mpi_feature "#include <mpi.h>" \
+		"MPI_Psend_init(0, 1, 1, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_INFO_NULL, &request)"; then
+	skip_partitioned=1
+fi
+
+skip_persistent_colls=0
+if ! has_mpi_feature "#include <mpi.h>" \
+		"MPI_Barrier_init(MPI_COMM_WORLD, MPI_INFO_NULL, &request)"; then
+	if ! has_mpi_feature "#include <mpi.h>\n#include <mpi-ext.h>" \
+			"MPIX_Barrier_init(MPI_COMM_WORLD, MPI_INFO_NULL, &request)"; then
+		skip_persistent_colls=1
+	fi
+fi
+
 nprogs=${#progs[@]}
 nfailed=0
 nskipped=0
@@ -264,6 +295,16 @@ for prog in "${progs[@]}"; do
 		nskipped=$(($nskipped + 1))
 		continue
 	fi
+	if [ $skip_partitioned -eq 1 ] && [[ "$prog" == *"Partitioned"* ]]; then
+		echo -e "${blue}SKIPPED${clean}"
+		nskipped=$(($nskipped + 1))
+		continue
+	fi
+	if [ $skip_persistent_colls -eq 1 ] && [[ "$prog" == *"PersistentCollective"* ]]; then
+		echo -e "${blue}SKIPPED${clean}"
+		nskipped=$(($nskipped + 1))
+		continue
+	fi
 	if [ $skip_omp -eq 1 ]; then
 		if [[ "$prog" == *".omp."* ]]; then
 			echo -e "${blue}SKIPPED${clean}"